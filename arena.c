@@ -0,0 +1,144 @@
+/*
+ * arena
+ *
+ * These functions allocate memory from an arena: a list of large blocks
+ * handed out a piece at a time by moving a pointer along, and freed all
+ * together.  The program model (program.c) keeps its symbols, notes and
+ * formatted text in one, so a mode that makes millions of them does not
+ * call malloc and free millions of times.
+ *
+ * void initArena(Arena * arena, size_t limit)
+ *   Makes arena empty.  It will take at most limit bytes from malloc, or
+ *   as many as it needs if limit is 0.
+ *
+ * void * arenaAlloc(Arena * arena, size_t size)
+ *   Returns: size bytes, aligned for any type, which stay valid until
+ *            freeArena, or NULL (after printing an error message) if
+ *            that would take the arena past its limit.
+ *
+ * char * arenaString(Arena * arena, const char * text)
+ * char * arenaPrintf(Arena * arena, const char * format, ...)
+ *   Return: a copy of text, or the text printf would print, in arena
+ *           (or NULL, as for arenaAlloc).
+ *
+ * void freeArena(Arena * arena)
+ *   Frees everything allocated from arena, and makes it empty again.
+ *
+ * Implementation:
+ *      Blocks are ARENA_BLOCK bytes, or larger for an object that would
+ *      not fit in one.  An allocation that does not fit in the rest of
+ *      the current block starts a new one; the rest is not used again,
+ *      which wastes little since objects are small next to a block.
+ *      arenaPrintf prints straight into the current block when the text
+ *      fits, so most strings are formatted once and never copied.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "disassembler.h"
+#include "arena.h"
+
+#define ARENA_BLOCK	(1 << 20)		/* bytes per block */
+#define ARENA_ALIGN	16				/* alignment of each allocation */
+
+struct ArenaBlock
+{
+	ArenaBlock * next;
+	size_t size;					/* bytes after the header */
+	_Alignas(ARENA_ALIGN) char data[];
+};
+
+void initArena(Arena * arena, size_t limit)
+{
+	arena->blocks = NULL;
+	arena->next = NULL;
+	arena->end = NULL;
+	arena->bytes = 0;
+	arena->used = 0;
+	arena->limit = limit;
+}
+
+void * arenaAlloc(Arena * arena, size_t size)
+{
+	ArenaBlock * block;
+	size_t blockSize;
+	void * p;
+
+	size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+	if (arena->next == NULL || size > (size_t)(arena->end - arena->next))
+	{
+		blockSize = size > ARENA_BLOCK ? size : ARENA_BLOCK;
+		if (arena->limit != 0 && arena->bytes + blockSize > arena->limit)
+		{
+			printError("Error: Out of memory for the program (the limit is %zu bytes; "
+					   "see --max-memory).\n", arena->limit);
+			return NULL;
+		}
+		if ((block = malloc(sizeof(ArenaBlock) + blockSize)) == NULL)
+		{
+			printError("Error: Not enough memory for the program.\n");
+			return NULL;
+		}
+		block->next = arena->blocks;
+		block->size = blockSize;
+		arena->blocks = block;
+		arena->next = block->data;
+		arena->end = block->data + blockSize;
+		arena->bytes += sizeof(ArenaBlock) + blockSize;
+	}
+
+	p = arena->next;
+	arena->next += size;
+	arena->used += size;
+	return p;
+}
+
+char * arenaString(Arena * arena, const char * text)
+{
+	size_t length = strlen(text) + 1;
+	char * copy = arenaAlloc(arena, length);
+
+	if (copy != NULL)
+		memcpy(copy, text, length);
+	return copy;
+}
+
+char * arenaPrintf(Arena * arena, const char * format, ...)
+{
+	va_list ap;
+	size_t room = arena->next != NULL ? (size_t)(arena->end - arena->next) : 0;
+	int length;
+	char * text;
+
+	va_start(ap, format);
+	length = vsnprintf(arena->next, room, format, ap);
+	va_end(ap);
+	if (length < 0)
+		return NULL;
+
+	if ((size_t)length < room)
+		return arenaAlloc(arena, (size_t)length + 1);	/* already printed there */
+
+	if ((text = arenaAlloc(arena, (size_t)length + 1)) != NULL)
+	{
+		va_start(ap, format);
+		vsnprintf(text, (size_t)length + 1, format, ap);
+		va_end(ap);
+	}
+	return text;
+}
+
+void freeArena(Arena * arena)
+{
+	ArenaBlock * block;
+
+	while ((block = arena->blocks) != NULL)
+	{
+		arena->blocks = block->next;
+		free(block);
+	}
+	initArena(arena, arena->limit);
+}
@@ -0,0 +1,30 @@
+/*
+ * This file provides the bump-pointer arena, from which many small
+ * objects are allocated and then freed all at once (see arena.c).
+ */
+
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <stddef.h>
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct
+{
+	ArenaBlock * blocks;	/* most recent first */
+	char * next;			/* next free byte in blocks */
+	char * end;				/* end of blocks */
+	size_t bytes;			/* bytes taken from malloc */
+	size_t used;			/* bytes handed out */
+	size_t limit;			/* most bytes to take from malloc, 0 for no limit */
+} Arena;
+
+void initArena(Arena * arena, size_t limit);
+void * arenaAlloc(Arena * arena, size_t size);
+char * arenaString(Arena * arena, const char * text);
+char * arenaPrintf(Arena * arena, const char * format, ...)
+	__attribute__((format(printf, 2, 3)));
+void freeArena(Arena * arena);
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * assembleInstruction
+ *
+ * This function is the reverse of processRaw: it converts one MIPS
+ * assembly instruction, written the way the disassembler prints it,
+ * back into a packed 32-bit instruction word.  For example
+ *          lw $t0, 1200($t1)       becomes 0x8d2804b0
+ *          add $t0, $s2, $t0       becomes 0x02484020
+ *
+ * const char * assembleInstruction(const char * text, unsigned int * word,
+ *                                  int strict)
+ *   Pre-condition:  text is a null-terminated string
+ *   Post-condition: if the instruction was valid, *word holds it
+ *   Returns: NULL if text was a valid instruction, otherwise a message
+ *            saying what was wrong with it.
+ *
+ *   Registers are written by name ("$t0") or number ("$8").  Numbers
+ *   are decimal, or hex with a leading 0x, and may be negative.
+ *   Branch offsets are in instructions (as processI prints them) and
+ *   jump targets are byte addresses (as processJ prints them).
+ *
+ *   If strict is 0, a 16-bit immediate may be anything from -32768 to
+ *   65535, which accepts everything the disassembler prints.  If strict
+ *   is 1, the immediate must fit the way the instruction uses it:
+ *   -32768 to 32767 for the sign-extended ones (addi, addiu, slti, sltiu,
+ *   beq, bne, lw, sw) and 0 to 65535 for andi, ori and lui; a jump
+ *   target must also be below 0x10000000.
+ *
+ * Implementation:
+ *      The mnemonic is looked up with findInstructionByName and the
+ *      registers with getRegNbr, both of which use perfect hashes, so
+ *      the cost of a line is just the pass over its characters.  The
+ *      operands are then parsed in the order given by the instruction's
+ *      layout in the instruction table.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+
+static const char * parseRegister(const char ** p, unsigned int * reg);
+static const char * parseNumber(const char ** p, long * number);
+static const char * expect(const char ** p, char c);
+static void skipSpaces(const char ** p);
+
+const char * assembleInstruction(const char * text, unsigned int * word, int strict)
+{
+	const InstrInfo * instr;
+	const char * p = text;
+	const char * error;
+	char mnemonic[8];
+	unsigned int rd = 0, rs = 0, rt = 0;
+	long number = 0;
+	long low, high;
+	int  length = 0;
+
+	/* Mnemonic */
+	skipSpaces(&p);
+	while (islower((unsigned char)*p) && length < (int)sizeof(mnemonic) - 1)
+	{
+		mnemonic[length++] = *p++;
+	}
+	mnemonic[length] = '\0';
+
+	if (length == 0 || (instr = findInstructionByName(mnemonic)) == NULL)
+		return "unknown mnemonic";
+
+	/* Operands, in the order the disassembler prints them. */
+	switch (instr->layout)
+	{
+		case LAYOUT_R3 :
+			if ((error = parseRegister(&p, &rd)) || (error = expect(&p, ','))
+				|| (error = parseRegister(&p, &rs)) || (error = expect(&p, ','))
+				|| (error = parseRegister(&p, &rt)))
+				return error;
+		break;
+
+		case LAYOUT_SHIFT :
+			if ((error = parseRegister(&p, &rd)) || (error = expect(&p, ','))
+				|| (error = parseRegister(&p, &rt)) || (error = expect(&p, ','))
+				|| (error = parseNumber(&p, &number)))
+				return error;
+			if (number < 0 || number > 31)
+				return "shift amount out of range";
+		break;
+
+		case LAYOUT_JR :
+			if ((error = parseRegister(&p, &rs)))
+				return error;
+		break;
+
+		case LAYOUT_ARITH :
+			if ((error = parseRegister(&p, &rt)) || (error = expect(&p, ','))
+				|| (error = parseRegister(&p, &rs)) || (error = expect(&p, ','))
+				|| (error = parseNumber(&p, &number)))
+				return error;
+		break;
+
+		case LAYOUT_BRANCH :
+			if ((error = parseRegister(&p, &rs)) || (error = expect(&p, ','))
+				|| (error = parseRegister(&p, &rt)) || (error = expect(&p, ','))
+				|| (error = parseNumber(&p, &number)))
+				return error;
+		break;
+
+		case LAYOUT_LUI :
+			if ((error = parseRegister(&p, &rt)) || (error = expect(&p, ','))
+				|| (error = parseNumber(&p, &number)))
+				return error;
+		break;
+
+		case LAYOUT_MEM :
+			if ((error = parseRegister(&p, &rt)) || (error = expect(&p, ','))
+				|| (error = parseNumber(&p, &number)) || (error = expect(&p, '('))
+				|| (error = parseRegister(&p, &rs)) || (error = expect(&p, ')')))
+				return error;
+		break;
+
+		case LAYOUT_JUMP :
+			if ((error = parseNumber(&p, &number)))
+				return error;
+			if (number & 3)
+				return "jump target is not a multiple of 4";
+			if (number < 0 || number > 0xFFFFFFFFL || (strict && number > 0x0FFFFFFF))
+				return "jump target out of range";
+			*word = ((unsigned int)instr->opcode << 26) | (((unsigned long)number >> 2) & 0x3FFFFFF);
+		break;
+	}
+
+	skipSpaces(&p);
+	if (*p != '\0' && *p != '#')
+		return "unexpected text after the operands";
+
+	if (instr->layout == LAYOUT_JUMP)
+		return NULL;
+
+	if (instr->format == 'R')
+	{
+		*word = (rs << 21) | (rt << 16) | (rd << 11)
+			| ((unsigned int)number << 6) | (unsigned int)instr->funct;
+		return NULL;
+	}
+
+	/* I format: check the immediate's range. */
+	if (!strict)
+	{
+		low = -32768;
+		high = 65535;
+	}
+	else if (instr->opcode == 12 || instr->opcode == 13 || instr->opcode == 15)
+	{
+		low = 0;			/* andi, ori and lui: zero-extended */
+		high = 65535;
+	}
+	else
+	{
+		low = -32768;		/* everything else: sign-extended */
+		high = 32767;
+	}
+
+	if (number < low || number > high)
+		return "immediate value out of range";
+
+	*word = ((unsigned int)instr->opcode << 26) | (rs << 21) | (rt << 16)
+		| ((unsigned int)number & 0xFFFF);
+	return NULL;
+}
+
+static void skipSpaces(const char ** p)
+{
+	while (**p == ' ' || **p == '\t')
+		(*p)++;
+}
+
+static const char * expect(const char ** p, char c)
+{
+	skipSpaces(p);
+	if (**p != c)
+	{
+		switch (c)
+		{
+			case ',' : return "expected ','";
+			case '(' : return "expected '('";
+			default  : return "expected ')'";
+		}
+	}
+	(*p)++;
+	return NULL;
+}
+
+static const char * parseRegister(const char ** p, unsigned int * reg)
+{
+	char name[8];
+	int  length = 0;
+	int  nbr;
+
+	skipSpaces(p);
+	if (**p != '$')
+		return "expected a register";
+
+	name[length++] = *(*p)++;
+	while (isalnum((unsigned char)**p) && length < (int)sizeof(name) - 1)
+	{
+		name[length++] = *(*p)++;
+	}
+	name[length] = '\0';
+
+	if ((nbr = getRegNbr(name)) < 0)
+		return "unknown register";
+
+	*reg = (unsigned int)nbr;
+	return NULL;
+}
+
+static const char * parseNumber(const char ** p, long * number)
+{
+	const char * start;
+	char * end;
+	int negative = 0;
+
+	skipSpaces(p);
+	if (**p == '-')
+	{
+		negative = 1;
+		(*p)++;
+	}
+
+	start = *p;
+	if (start[0] == '0' && (start[1] == 'x' || start[1] == 'X'))
+	{
+		start += 2;
+		*number = strtol(start, &end, 16);
+	}
+	else
+	{
+		*number = strtol(start, &end, 10);
+	}
+
+	if (end == start || !isxdigit((unsigned char)*start) || *number > 0xFFFFFFFFL)
+		return "expected a number";
+
+	if (negative)
+		*number = -*number;
+
+	*p = end;
+	return NULL;
+}
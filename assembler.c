@@ -0,0 +1,154 @@
+/*
+ * MIPS Assembler
+ *
+ * This program is the companion of the disassembler.  It reads MIPS
+ * assembly instructions, one per line, in the syntax the disassembler
+ * prints (e.g. "lw $t0, 1200($t1)" or "add $t0, $s2, $t0"), and writes
+ * the machine language for each one.
+ *
+ * Usage:
+ *          name [ --format bin|hex|raw ] [ --strict ] [ filename ] [ 0|1 ]
+ *      The filename and debugging choice are handled by
+ *      process_arguments, just as in the disassembler.
+ *          --format bin    32 '0'/'1' characters per line, the input
+ *                          format of the disassembler (the default)
+ *          --format hex    8 hex digits per line
+ *          --format raw    4 bytes per instruction, most significant first
+ *          --strict        only accept immediates in the range the
+ *                          instruction actually uses (see
+ *                          assembleInstruction.c)
+ *
+ * Input:
+ *      Blank lines and anything after a '#' are ignored.  A leading
+ *      "Line N: " is skipped, and lines holding just 32 '0'/'1'
+ *      characters are ignored, so the disassembler's own output can be
+ *      assembled again directly.
+ *
+ * Output:
+ *      The instructions, in the chosen format, on stdout.  For each line
+ *      that cannot be assembled, an error message on stderr giving the
+ *      line number and the problem.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+
+const int SAME = 0;		/* useful for making strcmp readable */
+						/* e.g., if (strcmp (str1, str2) == SAME) */
+
+static void writeWord(unsigned int word, int format);
+
+enum { FORMAT_BIN, FORMAT_HEX, FORMAT_RAW };
+
+int main(int argc, char *argv[])
+{
+	FILE * fptr;               /* file pointer */
+	LineReader * reader;       /* reads fptr in large blocks */
+	char * input;              /* line that is read in */
+	char * text;               /* start of the instruction in input */
+	char * end;
+	int    length;             /* length of line read in */
+	int    lineNum = 0;        /* keep track of input line numbers */
+	int    format = FORMAT_BIN;
+	int    errors = 0;
+	unsigned int word;
+	const char * error;
+	static char outputBuffer[1 << 20];
+
+	fptr = process_arguments(argc, argv);
+	if (fptr == NULL)
+	{
+		return 1;   /* Fatal error when processing arguments */
+	}
+
+	if (options.format == NULL || strcmp(options.format, "bin") == SAME)
+		format = FORMAT_BIN;
+	else if (strcmp(options.format, "hex") == SAME)
+		format = FORMAT_HEX;
+	else if (strcmp(options.format, "raw") == SAME)
+		format = FORMAT_RAW;
+	else
+	{
+		printError("Error: Unknown output format %s.\n", options.format);
+		return 1;
+	}
+
+	reader = openLineReader(fptr);
+	if (reader == NULL)
+	{
+		return 1;
+	}
+
+	setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+
+	while ((input = readLine(reader, &length)) != NULL)   /* NULL if EOF */
+	{
+		lineNum++;
+
+		/* Skip a "Line N: " prefix from the disassembler's output. */
+		text = input;
+		if (strncmp(text, "Line ", 5) == SAME)
+		{
+			strtol(text + 5, &end, 10);
+			if (end != text + 5 && end[0] == ':')
+				text = end + 1;
+		}
+		while (*text == ' ' || *text == '\t')
+			text++;
+
+		/* Blank lines, comments and echoed binary lines. */
+		if (*text == '\0' || *text == '#'
+			|| (strlen(text) == 32 && strspn(text, "01") == 32))
+			continue;
+
+		printDebug("Assembling: %s\n", text);
+
+		if ((error = assembleInstruction(text, &word, options.strict)) != NULL)
+		{
+			errors++;
+			printError("Error: Line %d: %s: %s\n", lineNum, error, text);
+			continue;
+		}
+
+		writeWord(word, format);
+	}
+
+	closeLineReader(reader);
+	fflush(stdout);
+	return errors > 0 ? 1 : 0;
+}
+
+static void writeWord(unsigned int word, int format)
+{
+	static const char hexDigits[] = "0123456789abcdef";
+	char text[34];
+	int i;
+
+	switch (format)
+	{
+		case FORMAT_BIN :
+			unpackMIPSInstruction(word, text);
+			text[32] = '\n';
+			fwrite(text, 1, 33, stdout);
+		break;
+
+		case FORMAT_HEX :
+			for (i = 7; i >= 0; i--)
+			{
+				text[i] = hexDigits[word & 0xF];
+				word >>= 4;
+			}
+			text[8] = '\n';
+			fwrite(text, 1, 9, stdout);
+		break;
+
+		default :
+			text[0] = (char)(word >> 24);
+			text[1] = (char)(word >> 16);
+			text[2] = (char)(word >> 8);
+			text[3] = (char)word;
+			fwrite(text, 1, 4, stdout);
+		break;
+	}
+}
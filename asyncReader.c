@@ -0,0 +1,666 @@
+/*
+ * asyncReader
+ *
+ * These functions read many files at once, so a run over thousands of
+ * small dump files does not wait on the storage for each file in turn.
+ * The reads of up to ASYNC_DEPTH files are in flight at a time, and the
+ * data is handed back file by file, in the order of the list, while the
+ * reads of the files after it go on.
+ *
+ * AsyncReader * openAsyncReader(char * const paths[], int nPaths,
+ *                               const char * backend, int threads)
+ *   Returns: a reader of the files paths[0..nPaths-1] (which must stay
+ *            valid until it is closed), or NULL (after printing an error
+ *            message) if backend is unknown.  backend is
+ *      "uring"     io_uring: the opens and reads are queued in the kernel
+ *                  and the data is read into buffers registered with it
+ *      "threads"   threads (threads of them, or 8 if threads is 0) that
+ *                  open and pread the files
+ *      "sync"      open and read each file when its turn comes
+ *      "auto"      (or NULL) uring if the kernel offers it, else threads
+ *
+ * const char * asyncBackend(const AsyncReader * reader)
+ *   Returns: the backend reader uses ("uring", "threads" or "sync").
+ *
+ * int nextChunk(AsyncReader * reader, Chunk * chunk)
+ *   Post-condition: chunk holds the next chunk of data: the files are
+ *                   taken in order, each in chunks of up to ASYNC_CHUNK
+ *                   bytes (as many as one read gave), then one with no
+ *                   data and chunk->last set, from the read that found
+ *                   the end of the file.  A file that cannot be opened or
+ *                   read gives a chunk with no data and chunk->error and
+ *                   chunk->last set.  The data stays valid until the
+ *                   next call.
+ *   Returns: 1, or 0 after the last file, or -1 (after printing an error
+ *            message) if io_uring fails.
+ *
+ * void closeAsyncReader(AsyncReader * reader)
+ *   Stops the threads or the ring, closes the files and frees the reader.
+ *
+ * char ** readPathList(const char * listPath, Arena * names, int * nPaths)
+ *   Returns: the names of files listed in the file listPath, one per line
+ *            (empty lines are skipped), copied into names, with their
+ *            number in *nPaths; or NULL (after printing an error message)
+ *            if the list cannot be read or names no files.  The array is
+ *            freed with free, the names with the arena.
+ *
+ * Implementation:
+ *      File i is read through slot i % ASYNC_DEPTH, and each slot has one
+ *      buffer and at most one open or read in flight, so the data of the
+ *      files comes back in order and the memory used is fixed.  When the
+ *      caller is done with a chunk, the slot's next read is started, or
+ *      if that was the last chunk, the slot starts on file
+ *      i + ASYNC_DEPTH.  The backends differ only in how an open or read
+ *      is started and how its completion is waited for:
+ *          uring   IORING_OP_OPENAT and IORING_OP_READ_FIXED entries go on
+ *                  the submission ring, and are submitted (with one
+ *                  io_uring_enter call for all that are queued) when the
+ *                  reader has to wait for a completion.  The rings are set
+ *                  up with the raw system calls, so no liburing is needed.
+ *          threads the requests go on a queue that the threads take them
+ *                  from, and the results come back on another.  A thread
+ *                  that opens a file reads its first chunk too, so a
+ *                  small file takes one trip through the queues.
+ *          sync    nothing is started ahead: the open or read for the
+ *                  file being handed back is done when the reader waits
+ *                  for it, so the files are read strictly one at a time.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#define _GNU_SOURCE		/* for O_CLOEXEC and pread */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#include "printFuncs.h"
+#include "lineReader.h"
+#include "asyncReader.h"
+
+#define ASYNC_DEPTH		64		/* files in flight, and buffers */
+#define DEFAULT_THREADS	8		/* threads for the threads backend */
+
+enum { BACKEND_URING, BACKEND_THREADS, BACKEND_SYNC };
+enum { SLOT_FREE, SLOT_OPENING, SLOT_READING, SLOT_READY, SLOT_FAILED };
+enum { OP_OPEN, OP_READ };
+
+typedef struct
+{
+	int file;
+	int fd;
+	off_t offset;				/* of the read in flight or ready */
+	int state;
+	long result;				/* bytes read, or -errno */
+} Slot;
+
+typedef struct
+{
+	int slot;
+	int op;						/* threads: the request */
+	long result;				/* the completion */
+} Request;
+
+typedef struct
+{
+	int fd;
+	unsigned int * sqHead;
+	unsigned int * sqTail;
+	unsigned int sqMask;
+	unsigned int * sqArray;
+	struct io_uring_sqe * sqes;
+	unsigned int * cqHead;
+	unsigned int * cqTail;
+	unsigned int cqMask;
+	struct io_uring_cqe * cqes;
+	void * sqMap;
+	void * cqMap;
+	size_t sqMapSize;
+	size_t cqMapSize;
+	size_t sqesSize;
+	unsigned int toSubmit;		/* queued but not yet submitted */
+} Ring;
+
+struct AsyncReader
+{
+	char * const * paths;
+	int nPaths;
+	int backend;
+	Slot slots[ASYNC_DEPTH];
+	char * buffers;				/* ASYNC_CHUNK bytes per slot */
+	int current;				/* the file being handed back */
+	int holding;				/* 1 if the caller has a chunk of it */
+
+	/* threads: the requests and their completions */
+	Request done[ASYNC_DEPTH];
+	int doneHead, doneCount;
+	Request work[ASYNC_DEPTH];
+	int workHead, workCount;
+	int stopping;
+	pthread_mutex_t lock;
+	pthread_cond_t workReady;
+	pthread_cond_t workDone;
+	pthread_t * threads;
+	int nThreads;
+
+	Ring ring;					/* uring */
+};
+
+static void startOp(AsyncReader * r, int slot, int op);
+static int waitOne(AsyncReader * r, int * slot, long * result);
+static void complete(AsyncReader * r, int slot, long result);
+static void startFile(AsyncReader * r, int slot, int file);
+static void release(AsyncReader * r);
+static long doOp(AsyncReader * r, int slot, int op);
+static void * worker(void * arg);
+static int setupRing(AsyncReader * r);
+static void teardownRing(Ring * ring);
+
+AsyncReader * openAsyncReader(char * const paths[], int nPaths, const char * backend,
+							  int threads)
+{
+	AsyncReader * r;
+	int i;
+
+	if ((r = calloc(1, sizeof(AsyncReader))) == NULL
+		|| (r->buffers = aligned_alloc(4096, (size_t)ASYNC_DEPTH * ASYNC_CHUNK)) == NULL)
+	{
+		printError("Error: Not enough memory for the file reader.\n");
+		free(r);
+		return NULL;
+	}
+	r->paths = paths;
+	r->nPaths = nPaths;
+	r->ring.fd = -1;
+	for (i = 0; i < ASYNC_DEPTH; i++)
+		r->slots[i].fd = -1;
+
+	if (backend == NULL || strcmp(backend, "auto") == 0)
+		r->backend = setupRing(r) ? BACKEND_URING : BACKEND_THREADS;
+	else if (strcmp(backend, "uring") == 0)
+	{
+		r->backend = BACKEND_URING;
+		if (!setupRing(r))
+		{
+			printError("Error: io_uring is not available here (use --io threads).\n");
+			closeAsyncReader(r);
+			return NULL;
+		}
+	}
+	else if (strcmp(backend, "threads") == 0)
+		r->backend = BACKEND_THREADS;
+	else if (strcmp(backend, "sync") == 0)
+		r->backend = BACKEND_SYNC;
+	else
+	{
+		printError("Error: Unknown I/O backend %s (use auto, uring, threads or sync).\n", backend);
+		closeAsyncReader(r);
+		return NULL;
+	}
+
+	if (r->backend == BACKEND_THREADS)
+	{
+		if ((r->threads = malloc((size_t)(threads > 0 ? threads : DEFAULT_THREADS)
+								 * sizeof(pthread_t))) == NULL)
+		{
+			printError("Error: Not enough memory for the file reader.\n");
+			closeAsyncReader(r);
+			return NULL;
+		}
+		r->nThreads = threads > 0 ? threads : DEFAULT_THREADS;
+		pthread_mutex_init(&r->lock, NULL);
+		pthread_cond_init(&r->workReady, NULL);
+		pthread_cond_init(&r->workDone, NULL);
+		for (i = 0; i < r->nThreads; i++)
+		{
+			if (pthread_create(&r->threads[i], NULL, worker, r) != 0)
+			{
+				r->nThreads = i;
+				printError("Error: Cannot start the reading threads.\n");
+				closeAsyncReader(r);
+				return NULL;
+			}
+		}
+	}
+
+	for (i = 0; i < ASYNC_DEPTH && i < nPaths; i++)
+		startFile(r, i, i);
+	return r;
+}
+
+const char * asyncBackend(const AsyncReader * r)
+{
+	static const char * const names[] = { "uring", "threads", "sync" };
+
+	return names[r->backend];
+}
+
+int nextChunk(AsyncReader * r, Chunk * chunk)
+{
+	Slot * s;
+	long result;
+	int slot;
+
+	if (r->holding)
+		release(r);
+	if (r->current >= r->nPaths)
+		return 0;
+
+	s = &r->slots[r->current % ASYNC_DEPTH];
+	while (s->state != SLOT_READY && s->state != SLOT_FAILED)
+	{
+		if (!waitOne(r, &slot, &result))
+			return -1;
+		complete(r, slot, result);
+	}
+
+	chunk->file = r->current;
+	chunk->data = r->buffers + (size_t)(r->current % ASYNC_DEPTH) * ASYNC_CHUNK;
+	chunk->length = s->state == SLOT_READY ? (size_t)s->result : 0;
+	chunk->last = s->state == SLOT_FAILED || s->result == 0;
+	chunk->error = s->state == SLOT_FAILED ? (int)-s->result : 0;
+	r->holding = 1;
+	return 1;
+}
+
+char ** readPathList(const char * listPath, Arena * names, int * nPaths)
+{
+	FILE * fptr;
+	LineReader * list;
+	char ** paths = NULL;
+	char ** grown;
+	char * name;
+	int capacity = 0;
+	int length;
+
+	if ((fptr = fopen(listPath, "r")) == NULL)
+	{
+		printError("Error: Cannot open file %s.\n", listPath);
+		return NULL;
+	}
+	if ((list = openLineReader(fptr)) == NULL)
+		return NULL;
+
+	*nPaths = 0;
+	while ((name = readLine(list, &length)) != NULL)
+	{
+		if (length == 0)
+			continue;
+		if (*nPaths == capacity)
+		{
+			capacity = capacity ? 2 * capacity : 1024;
+			if ((grown = realloc(paths, (size_t)capacity * sizeof(char *))) == NULL)
+			{
+				printError("Error: Not enough memory for the list of files.\n");
+				break;
+			}
+			paths = grown;
+		}
+		if ((paths[*nPaths] = arenaString(names, name)) == NULL)
+			break;
+		(*nPaths)++;
+	}
+	closeLineReader(list);
+
+	if (name != NULL || *nPaths == 0)
+	{
+		if (name == NULL)
+			printError("Error: No files are named in %s.\n", listPath);
+		free(paths);
+		return NULL;
+	}
+	return paths;
+}
+
+void closeAsyncReader(AsyncReader * r)
+{
+	int slot;
+	long result;
+	int i;
+
+	/* Let what is in flight finish, so nothing writes to freed buffers. */
+	for (i = 0; i < ASYNC_DEPTH && r->ring.fd >= 0; i++)
+	{
+		while (r->slots[i].state == SLOT_OPENING || r->slots[i].state == SLOT_READING)
+		{
+			if (!waitOne(r, &slot, &result))
+				break;
+			r->slots[slot].state = result < 0 ? SLOT_FAILED : SLOT_READY;
+			if (r->slots[slot].fd < 0 && result >= 0)
+				r->slots[slot].fd = (int)result;
+		}
+	}
+
+	if (r->nThreads > 0)
+	{
+		pthread_mutex_lock(&r->lock);
+		r->stopping = 1;
+		pthread_cond_broadcast(&r->workReady);
+		pthread_mutex_unlock(&r->lock);
+		for (i = 0; i < r->nThreads; i++)
+			pthread_join(r->threads[i], NULL);
+	}
+	free(r->threads);
+
+	for (i = 0; i < ASYNC_DEPTH; i++)
+	{
+		if (r->slots[i].fd >= 0)
+			close(r->slots[i].fd);
+	}
+	teardownRing(&r->ring);
+	free(r->buffers);
+	free(r);
+}
+
+/* Starts reading file through slot, with an open. */
+static void startFile(AsyncReader * r, int slot, int file)
+{
+	Slot * s = &r->slots[slot];
+
+	s->file = file;
+	s->fd = -1;
+	s->offset = 0;
+	s->state = SLOT_OPENING;
+	startOp(r, slot, OP_OPEN);
+}
+
+/* The caller is done with the current chunk: read the next one, or move
+ * the slot on to its next file.
+ */
+static void release(AsyncReader * r)
+{
+	int slot = r->current % ASYNC_DEPTH;
+	Slot * s = &r->slots[slot];
+
+	r->holding = 0;
+	if (s->state == SLOT_READY && s->result > 0)
+	{
+		s->offset += s->result;
+		s->state = SLOT_READING;
+		startOp(r, slot, OP_READ);
+		return;
+	}
+
+	if (s->fd >= 0)
+		close(s->fd);
+	s->fd = -1;
+	s->state = SLOT_FREE;
+	if (r->current + ASYNC_DEPTH < r->nPaths)
+		startFile(r, slot, r->current + ASYNC_DEPTH);
+	r->current++;
+}
+
+/* Records the result of the open or read in flight on slot. */
+static void complete(AsyncReader * r, int slot, long result)
+{
+	Slot * s = &r->slots[slot];
+
+	s->result = result;
+	if (result < 0)
+		s->state = SLOT_FAILED;
+	else if (s->state == SLOT_OPENING && r->backend == BACKEND_URING)
+	{
+		s->fd = (int)result;
+		s->state = SLOT_READING;
+		startOp(r, slot, OP_READ);
+	}
+	else
+		s->state = SLOT_READY;
+}
+
+static void startOp(AsyncReader * r, int slot, int op)
+{
+	Slot * s = &r->slots[slot];
+	Ring * ring = &r->ring;
+	struct io_uring_sqe * sqe;
+	unsigned int tail, index;
+
+	switch (r->backend)
+	{
+		case BACKEND_SYNC :
+			break;						/* done by waitOne, in turn */
+
+		case BACKEND_THREADS :
+			pthread_mutex_lock(&r->lock);
+			r->work[(r->workHead + r->workCount) % ASYNC_DEPTH].slot = slot;
+			r->work[(r->workHead + r->workCount) % ASYNC_DEPTH].op = op;
+			r->workCount++;
+			pthread_cond_signal(&r->workReady);
+			pthread_mutex_unlock(&r->lock);
+		break;
+
+		case BACKEND_URING :
+			/* One entry per slot at most is in flight, and the ring has
+			 * ASYNC_DEPTH entries, so there is always room.
+			 */
+			tail = *ring->sqTail;
+			index = tail & ring->sqMask;
+			sqe = &ring->sqes[index];
+			memset(sqe, 0, sizeof(*sqe));
+			if (op == OP_OPEN)
+			{
+				sqe->opcode = IORING_OP_OPENAT;
+				sqe->fd = AT_FDCWD;
+				sqe->addr = (uint64_t)(uintptr_t)r->paths[s->file];
+				sqe->open_flags = O_RDONLY | O_CLOEXEC;
+			}
+			else
+			{
+				sqe->opcode = IORING_OP_READ_FIXED;
+				sqe->fd = s->fd;
+				sqe->addr = (uint64_t)(uintptr_t)(r->buffers + (size_t)slot * ASYNC_CHUNK);
+				sqe->len = ASYNC_CHUNK;
+				sqe->off = (uint64_t)s->offset;
+				sqe->buf_index = (uint16_t)slot;
+			}
+			sqe->user_data = (uint64_t)slot;
+			ring->sqArray[index] = index;
+			__atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+			ring->toSubmit++;
+		break;
+	}
+}
+
+/* Waits for an open or read to finish.  Returns 0 if io_uring fails. */
+static int waitOne(AsyncReader * r, int * slot, long * result)
+{
+	Ring * ring = &r->ring;
+	struct io_uring_cqe * cqe;
+	unsigned int head;
+	int submitted;
+
+	switch (r->backend)
+	{
+		case BACKEND_SYNC :
+			/* Only the current file's slot is ever waited for. */
+			*slot = r->current % ASYNC_DEPTH;
+			*result = doOp(r, *slot, r->slots[*slot].state == SLOT_OPENING ? OP_OPEN : OP_READ);
+			return 1;
+
+		case BACKEND_THREADS :
+			pthread_mutex_lock(&r->lock);
+			while (r->doneCount == 0)
+				pthread_cond_wait(&r->workDone, &r->lock);
+			*slot = r->done[r->doneHead].slot;
+			*result = r->done[r->doneHead].result;
+			r->doneHead = (r->doneHead + 1) % ASYNC_DEPTH;
+			r->doneCount--;
+			pthread_mutex_unlock(&r->lock);
+			return 1;
+
+		case BACKEND_URING :
+			for (;;)
+			{
+				head = *ring->cqHead;
+				if (head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE))
+				{
+					cqe = &ring->cqes[head & ring->cqMask];
+					*slot = (int)cqe->user_data;
+					*result = cqe->res;
+					__atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+					return 1;
+				}
+
+				submitted = (int)syscall(__NR_io_uring_enter, ring->fd, ring->toSubmit, 1,
+										 IORING_ENTER_GETEVENTS, NULL, 0);
+				if (submitted < 0 && errno != EINTR)
+				{
+					printError("Error: io_uring failed: %s.\n", strerror(errno));
+					return 0;
+				}
+				if (submitted > 0)
+					ring->toSubmit -= (unsigned int)submitted;
+			}
+	}
+	return 0;
+}
+
+/* Opens or reads for slot, as the sync and threads backends do.  An
+ * open is followed at once by the first read, and gives its result.  A
+ * pipe, which pread cannot read, is read with read.
+ */
+static long doOp(AsyncReader * r, int slot, int op)
+{
+	Slot * s = &r->slots[slot];
+	ssize_t got;
+
+	if (op == OP_OPEN && (s->fd = open(r->paths[s->file], O_RDONLY | O_CLOEXEC)) < 0)
+		return -errno;
+
+	do
+	{
+		got = pread(s->fd, r->buffers + (size_t)slot * ASYNC_CHUNK, ASYNC_CHUNK, s->offset);
+		if (got < 0 && errno == ESPIPE)		/* a pipe: read in order */
+			got = read(s->fd, r->buffers + (size_t)slot * ASYNC_CHUNK, ASYNC_CHUNK);
+	} while (got < 0 && errno == EINTR);
+	return got < 0 ? -errno : got;
+}
+
+static void * worker(void * arg)
+{
+	AsyncReader * r = arg;
+	Request request;
+
+	pthread_mutex_lock(&r->lock);
+	for (;;)
+	{
+		while (r->workCount == 0 && !r->stopping)
+			pthread_cond_wait(&r->workReady, &r->lock);
+		if (r->workCount == 0)
+			break;
+
+		request = r->work[r->workHead];
+		r->workHead = (r->workHead + 1) % ASYNC_DEPTH;
+		r->workCount--;
+		pthread_mutex_unlock(&r->lock);
+
+		request.result = doOp(r, request.slot, request.op);
+
+		pthread_mutex_lock(&r->lock);
+		r->done[(r->doneHead + r->doneCount) % ASYNC_DEPTH] = request;
+		r->doneCount++;
+		pthread_cond_signal(&r->workDone);
+	}
+	pthread_mutex_unlock(&r->lock);
+	return NULL;
+}
+
+/* Sets up the rings and registers the buffers.  Returns 0 if the kernel
+ * does not offer io_uring with the opens and fixed reads used here.
+ */
+static int setupRing(AsyncReader * r)
+{
+	Ring * ring = &r->ring;
+	struct io_uring_params params;
+	struct iovec buffers[ASYNC_DEPTH];
+	struct io_uring_probe * probe;
+	unsigned char * sq;
+	unsigned char * cq;
+	size_t probeSize = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+	int supported;
+	int i;
+
+	memset(&params, 0, sizeof(params));
+	if ((ring->fd = (int)syscall(__NR_io_uring_setup, ASYNC_DEPTH, &params)) < 0)
+		return 0;
+
+	ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ring->cqMapSize > ring->sqMapSize)
+			ring->sqMapSize = ring->cqMapSize;
+		ring->cqMapSize = 0;
+	}
+	ring->sqMap = mmap(NULL, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+					   ring->fd, IORING_OFF_SQ_RING);
+	ring->cqMap = ring->cqMapSize == 0 ? ring->sqMap
+		: mmap(NULL, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			   ring->fd, IORING_OFF_CQ_RING);
+	ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+					  ring->fd, IORING_OFF_SQES);
+	if (ring->sqMap == MAP_FAILED || ring->cqMap == MAP_FAILED || ring->sqes == MAP_FAILED)
+	{
+		teardownRing(ring);
+		return 0;
+	}
+
+	sq = ring->sqMap;
+	cq = ring->cqMap;
+	ring->sqHead = (unsigned int *)(sq + params.sq_off.head);
+	ring->sqTail = (unsigned int *)(sq + params.sq_off.tail);
+	ring->sqMask = *(unsigned int *)(sq + params.sq_off.ring_mask);
+	ring->sqArray = (unsigned int *)(sq + params.sq_off.array);
+	ring->cqHead = (unsigned int *)(cq + params.cq_off.head);
+	ring->cqTail = (unsigned int *)(cq + params.cq_off.tail);
+	ring->cqMask = *(unsigned int *)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+	/* The opens and fixed reads must both be supported. */
+	probe = calloc(1, probeSize);
+	supported = probe != NULL
+		&& syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, 256) == 0
+		&& probe->last_op >= IORING_OP_OPENAT
+		&& (probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED)
+		&& (probe->ops[IORING_OP_READ_FIXED].flags & IO_URING_OP_SUPPORTED);
+	free(probe);
+
+	for (i = 0; i < ASYNC_DEPTH; i++)
+	{
+		buffers[i].iov_base = r->buffers + (size_t)i * ASYNC_CHUNK;
+		buffers[i].iov_len = ASYNC_CHUNK;
+	}
+	if (!supported
+		|| syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, buffers,
+				   ASYNC_DEPTH) != 0)
+	{
+		teardownRing(ring);
+		return 0;
+	}
+
+	return 1;
+}
+
+static void teardownRing(Ring * ring)
+{
+	if (ring->sqes != NULL && ring->sqes != MAP_FAILED)
+		munmap(ring->sqes, ring->sqesSize);
+	if (ring->cqMapSize != 0 && ring->cqMap != NULL && ring->cqMap != MAP_FAILED)
+		munmap(ring->cqMap, ring->cqMapSize);
+	if (ring->sqMap != NULL && ring->sqMap != MAP_FAILED)
+		munmap(ring->sqMap, ring->sqMapSize);
+	if (ring->fd >= 0)
+		close(ring->fd);			/* also unregisters the buffers */
+	memset(ring, 0, sizeof(Ring));
+	ring->fd = -1;
+}
@@ -0,0 +1,34 @@
+/*
+ * This file provides the signatures for the asynchronous file reader,
+ * which keeps the reads of many files in flight and hands their data
+ * back in order, a chunk at a time (see asyncReader.c).
+ */
+
+#ifndef _ASYNC_READER_H
+#define _ASYNC_READER_H
+
+#include <stddef.h>
+
+#include "arena.h"
+
+#define ASYNC_CHUNK	(128 * 1024)	/* most bytes in one chunk */
+
+typedef struct AsyncReader AsyncReader;
+
+typedef struct
+{
+	int file;				/* index in the list of paths */
+	char * data;			/* the chunk; may be written to until the next call */
+	size_t length;
+	int last;				/* 1 for the last chunk of the file */
+	int error;				/* errno if the file could not be read, else 0 */
+} Chunk;
+
+AsyncReader * openAsyncReader(char * const paths[], int nPaths, const char * backend,
+							  int threads);
+const char * asyncBackend(const AsyncReader * reader);
+int nextChunk(AsyncReader * reader, Chunk * chunk);
+void closeAsyncReader(AsyncReader * reader);
+char ** readPathList(const char * listPath, Arena * names, int * nPaths);
+
+#endif
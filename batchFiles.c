@@ -0,0 +1,168 @@
+/*
+ * batchFiles
+ *
+ * This function disassembles a whole list of files in one run, for
+ * batches of thousands of small dump files, where opening and reading
+ * each file in turn would leave the program waiting on the storage most
+ * of the time.
+ *
+ * int disassembleFiles(const char * listPath)
+ *   Reads the names of the files, one per line, from the file listPath,
+ *   and disassembles each file as the main loop would, after a line
+ *      ==> name <==
+ *   giving its name.  Line numbers start again at 1 in each file.  A
+ *   file that cannot be read is reported and skipped.  The error limit
+ *   counts the errors in all the files together.  --io picks how
+ *   the files are read (see asyncReader.c), and --threads how many
+ *   threads read them if threads are used.
+ *   Returns: the exit status for main (0, or 1 if the list cannot be
+ *            read or a file could not be).
+ *
+ * Implementation:
+ *      The files are read by an AsyncReader, which keeps the reads of
+ *      many of them in flight while this function decodes the chunks
+ *      that have come back.  Lines are decoded where they lie in a chunk
+ *      (the newline is overwritten with a null byte); only a line split
+ *      between two chunks is copied, into a carry buffer, which keeps at
+ *      most LINE_LIMIT characters of it as the line reader does.  The
+ *      files are read as binary lines; compressed files and images are
+ *      not recognized here.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+#include "arena.h"
+#include "asyncReader.h"
+
+typedef struct
+{
+	char line[LINE_LIMIT + 2];	/* start of a line split between chunks */
+	size_t kept;				/* characters of it in line */
+	size_t total;				/* characters of it seen */
+	int lineNum;
+} Carry;
+
+static void decodeChunk(Carry * carry, char * data, size_t length, int last);
+static void addToCarry(Carry * carry, const char * data, size_t length);
+static void decodeLine(int lineNum, char * input, size_t length);
+
+int disassembleFiles(const char * listPath)
+{
+	Arena names;
+	char ** paths;
+	int nPaths;
+	AsyncReader * reader;
+	Chunk chunk;
+	Carry carry;
+	int current = -1;
+	int status = 0;
+	int got;
+
+	initArena(&names, 0);
+	if ((paths = readPathList(listPath, &names, &nPaths)) == NULL)
+	{
+		freeArena(&names);
+		return 1;
+	}
+
+	if ((reader = openAsyncReader(paths, nPaths, options.io, (int)options.threads)) == NULL)
+	{
+		free(paths);
+		freeArena(&names);
+		return 1;
+	}
+	printDebug("Reading %d files with %s\n", nPaths, asyncBackend(reader));
+
+	while ((got = nextChunk(reader, &chunk)) > 0)
+	{
+		if (chunk.file != current)
+		{
+			current = chunk.file;
+			carry.kept = carry.total = 0;
+			carry.lineNum = 0;
+			printf("\n==> %s <==\n", paths[current]);
+		}
+
+		if (chunk.error != 0)
+		{
+			printError("Error: Cannot read file %s: %s.\n", paths[current],
+					   strerror(chunk.error));
+			status = 1;
+			continue;
+		}
+		decodeChunk(&carry, chunk.data, chunk.length, chunk.last);
+	}
+
+	closeAsyncReader(reader);
+	free(paths);
+	freeArena(&names);
+	return got < 0 ? 1 : status;
+}
+
+/* Decodes the lines in one chunk of a file: the lines that end in it,
+ * and if it is the last chunk, a final line with no newline.
+ */
+static void decodeChunk(Carry * carry, char * data, size_t length, int last)
+{
+	char * end = data + length;
+	char * newline;
+
+	while ((newline = memchr(data, '\n', (size_t)(end - data))) != NULL)
+	{
+		carry->lineNum++;
+		if (carry->total == 0 && newline - data <= LINE_LIMIT + 1)
+		{
+			*newline = '\0';
+			decodeLine(carry->lineNum, data, (size_t)(newline - data));
+		}
+		else
+		{
+			addToCarry(carry, data, (size_t)(newline - data));
+			decodeLine(carry->lineNum, carry->line,
+					   carry->total > LINE_LIMIT + 1 ? LINE_LIMIT : carry->kept);
+			carry->kept = carry->total = 0;
+		}
+		data = newline + 1;
+	}
+
+	addToCarry(carry, data, (size_t)(end - data));
+	if (last && carry->total > 0)
+	{
+		carry->lineNum++;
+		decodeLine(carry->lineNum, carry->line,
+				   carry->total > LINE_LIMIT + 1 ? LINE_LIMIT : carry->kept);
+	}
+}
+
+/* Adds length characters to the line being carried over, keeping the
+ * first LINE_LIMIT + 1 of them (enough to cut the line or strip a '\r').
+ */
+static void addToCarry(Carry * carry, const char * data, size_t length)
+{
+	size_t room = LINE_LIMIT + 1 - carry->kept;
+
+	carry->total += length;
+	if (length > room)
+		length = room;
+	memcpy(carry->line + carry->kept, data, length);
+	carry->kept += length;
+}
+
+/* Prints one line and its instruction, as the main loop does. */
+static void decodeLine(int lineNum, char * input, size_t length)
+{
+	if (length > 0 && input[length - 1] == '\r')
+		length--;
+	if (length > LINE_LIMIT)
+		length = LINE_LIMIT;
+	input[length] = '\0';
+
+	printf("\nLine %d: %s\n", lineNum, input);
+	printDebug("Length: %d\n", (int)length);
+	if (verifyMIPSInstruction(lineNum, input) == 1)
+	{
+		printf("Line %d: %s\n", lineNum, processRaw(input));
+		checkErrorCount();
+	}
+}
@@ -0,0 +1,317 @@
+/*
+ * callGraph
+ *
+ * This file implements the --callgraph option: treat every jal target
+ * as the entry of a function, give each instruction to the function it
+ * falls in, and print which functions call which, and how often.
+ *
+ * int printCallGraph(LineReader * reader, const char * format)
+ *   Reads the whole input and prints the call graph, either as
+ *      "dot"   a Graphviz digraph: one node per function, labeled with
+ *              its address and number of instructions, and one edge per
+ *              caller and callee, labeled with the number of calls
+ *      "csv"   one line per function and one per edge:
+ *                  kind,function,callee,count
+ *                  function,0x00400000,,120
+ *                  call,0x00400000,0x00400120,3
+ *              where count is the number of instructions of a function
+ *              and the number of calls for an edge
+ *   Returns: the exit status for main (0 unless the program was empty,
+ *            format was unknown or there was not enough memory).
+ *
+ * The first instruction is always a function entry, for the code that
+ * runs before any call.  A function runs from its entry to the next
+ * entry, or to the end of the program, and has the instructions in that
+ * range (an image may leave gaps).  Instructions are at the addresses
+ * the image gives, or for lines, at --base onwards.  Targets are worked
+ * out as for j and jal in the simulator; a target outside the program
+ * is a function with no instructions.
+ *
+ * Implementation:
+ *      One pass over the input interns each distinct target in a hash
+ *      table and records each jal as a pair (call site, target), 8 bytes
+ *      per call, so memory grows with the number of calls and targets,
+ *      not with the size of the program.  Afterwards the targets are
+ *      sorted by address; since the call sites were recorded in program
+ *      order, one walk along the sorted entries finds each site's
+ *      calling function.  The (caller, callee) pairs are then sorted, and
+ *      runs of equal pairs are the edges with their call counts.  The
+ *      instructions are kept only as runs of consecutive addresses (one
+ *      run, unless the image has gaps), and a function's size is how
+ *      much of the runs lies between its entry and the next, so no
+ *      per-instruction table is needed.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+
+#include "disassembler.h"
+
+#define CALL_BLOCK	65536		/* words read at a time */
+
+typedef struct
+{
+	uint32_t start;			/* address of the first instruction */
+	uint32_t count;			/* instructions at consecutive addresses */
+} Run;
+
+typedef struct
+{
+	uint32_t first;			/* caller: call site, then calling function */
+	uint32_t second;		/* callee: target id, then function */
+} CallPair;
+
+typedef struct
+{
+	uint32_t * addresses;	/* address of each target id */
+	uint32_t count;
+	uint32_t capacity;
+	int32_t * slots;		/* hash table of ids, -1 if free */
+	uint32_t nSlots;		/* a power of 2 */
+} TargetTable;
+
+static int internTarget(TargetTable * table, uint32_t address, uint32_t * id);
+static int compareAddresses(const void * a, const void * b);
+static int comparePairs(const void * a, const void * b);
+
+int printCallGraph(LineReader * reader, const char * format)
+{
+	static unsigned int words[CALL_BLOCK];
+	static int lineNums[CALL_BLOCK];
+	static unsigned int addresses[CALL_BLOCK];
+	TargetTable targets = { NULL, 0, 0, NULL, 0 };
+	CallPair * calls = NULL;
+	size_t nCalls = 0, callCapacity = 0;
+	Run * runs = NULL, * moreRuns;
+	CallPair * moreCalls;
+	size_t nRuns = 0, runCapacity = 0, r;
+	uint32_t * entries = NULL;	/* function entries, sorted */
+	uint32_t * functionOf = NULL;	/* target id -> function */
+	uint32_t nFunctions;
+	unsigned int nextAddress = (unsigned int)options.textBase;
+	uint64_t next, from, to;
+	uint32_t address, f, i;
+	size_t c, run;
+	int dot;
+	int lineNum = 0;
+	int total = 0;
+	int ok = 1;
+	int n, k;
+
+	if (strcmp(format, "dot") != SAME && strcmp(format, "csv") != SAME)
+	{
+		printError("Error: Unknown call graph format %s (use dot or csv).\n", format);
+		return 1;
+	}
+	dot = strcmp(format, "dot") == SAME;
+
+	targets.nSlots = 1024;
+	if ((targets.slots = malloc(targets.nSlots * sizeof(int32_t))) == NULL)
+		ok = 0;
+	else
+		memset(targets.slots, -1, targets.nSlots * sizeof(int32_t));
+
+	while (ok && (n = readAddressBlock(reader, words, addresses, lineNums, CALL_BLOCK,
+									   &lineNum, &nextAddress)) > 0)
+	{
+		for (k = 0; ok && k < n; k++, total++)
+		{
+			address = addresses[k];
+			if (total == 0 && !internTarget(&targets, address, &i))
+				ok = 0;
+			else if (nRuns > 0 && address == runs[nRuns - 1].start + 4 * runs[nRuns - 1].count)
+				runs[nRuns - 1].count++;
+			else
+			{
+				if (nRuns == runCapacity)
+				{
+					runCapacity = runCapacity ? 2 * runCapacity : 16;
+					if ((moreRuns = realloc(runs, runCapacity * sizeof(Run))) == NULL)
+					{
+						ok = 0;
+						continue;
+					}
+					runs = moreRuns;
+				}
+				runs[nRuns].start = address;
+				runs[nRuns].count = 1;
+				nRuns++;
+			}
+
+			if (!ok || OPCODE(words[k]) != 3)				/* jal */
+				continue;
+
+			if (nCalls == callCapacity)
+			{
+				callCapacity = callCapacity ? 2 * callCapacity : 4096;
+				if ((moreCalls = realloc(calls, callCapacity * sizeof(CallPair))) == NULL)
+				{
+					ok = 0;
+					continue;
+				}
+				calls = moreCalls;
+			}
+			calls[nCalls].first = address;
+			if (!internTarget(&targets, ((address + 4) & 0xF0000000) | (TARGET(words[k]) << 2),
+							  &calls[nCalls].second))
+				ok = 0;
+			nCalls++;
+		}
+	}
+
+	if (!ok)
+		printError("Error: Not enough memory for the call graph.\n");
+	else if (total == 0)
+		printError("Error: The program has no instructions.\n");
+	else
+	{
+		nFunctions = targets.count;
+		entries = malloc(nFunctions * sizeof(uint32_t));
+		functionOf = malloc(nFunctions * sizeof(uint32_t));
+		if (entries == NULL || functionOf == NULL)
+		{
+			printError("Error: Not enough memory for the call graph.\n");
+			ok = 0;
+		}
+	}
+	if (!ok || total == 0)
+	{
+		free(entries);
+		free(functionOf);
+		free(targets.addresses);
+		free(targets.slots);
+		free(calls);
+		free(runs);
+		return 1;
+	}
+	qsort(runs, nRuns, sizeof(Run), compareAddresses);		/* by start */
+
+	/* Sort the entries, and number the functions in address order. */
+	memcpy(entries, targets.addresses, nFunctions * sizeof(uint32_t));
+	qsort(entries, nFunctions, sizeof(uint32_t), compareAddresses);
+	for (i = 0; i < nFunctions; i++)
+	{
+		uint32_t * found = bsearch(&targets.addresses[i], entries, nFunctions,
+								   sizeof(uint32_t), compareAddresses);
+		functionOf[i] = (uint32_t)(found - entries);
+	}
+
+	/* The call sites are in address order: walk the entries alongside. */
+	for (c = 0, f = 0; c < nCalls; c++)
+	{
+		while (f + 1 < nFunctions && entries[f + 1] <= calls[c].first)
+			f++;
+		calls[c].first = f;
+		calls[c].second = functionOf[calls[c].second];
+	}
+	qsort(calls, nCalls, sizeof(CallPair), comparePairs);
+
+	printf(dot ? "digraph callgraph {\n" : "kind,function,callee,count\n");
+	for (f = 0, r = 0; f < nFunctions; f++)
+	{
+		/* Count the instructions of the runs from this entry to the next. */
+		next = f + 1 < nFunctions ? entries[f + 1] : (uint64_t)1 << 32;
+		while (r < nRuns && runs[r].start + 4 * (uint64_t)runs[r].count <= entries[f])
+			r++;
+		for (k = 0, i = (uint32_t)r; i < nRuns && runs[i].start < next; i++)
+		{
+			from = runs[i].start > entries[f] ? runs[i].start : entries[f];
+			to = runs[i].start + 4 * (uint64_t)runs[i].count;
+			k += (int)(((to < next ? to : next) - from) / 4);
+		}
+		if (dot)
+			printf("  f%08x [label=\"0x%08x\\n%d instructions\"];\n", entries[f], entries[f], k);
+		else
+			printf("function,0x%08x,,%d\n", entries[f], k);
+	}
+	for (c = 0; c < nCalls; c += run)
+	{
+		for (run = 1; c + run < nCalls && comparePairs(&calls[c], &calls[c + run]) == 0; run++)
+			;
+		if (dot)
+			printf("  f%08x -> f%08x [label=\"%zu\"];\n",
+				   entries[calls[c].first], entries[calls[c].second], run);
+		else
+			printf("call,0x%08x,0x%08x,%zu\n",
+				   entries[calls[c].first], entries[calls[c].second], run);
+	}
+	if (dot)
+		printf("}\n");
+
+	free(entries);
+	free(functionOf);
+	free(targets.addresses);
+	free(targets.slots);
+	free(calls);
+	free(runs);
+	return 0;
+}
+
+/* Sets *id to the id of a target address, giving it the next id if it is
+ * new.  Returns 0 if there is not enough memory to add it.
+ */
+static int internTarget(TargetTable * table, uint32_t address, uint32_t * id)
+{
+	int32_t * slots;
+	uint32_t * addresses;
+	uint32_t slot;
+	uint32_t i;
+
+	if (2 * (table->count + 1) > table->nSlots)
+	{
+		if ((slots = realloc(table->slots, 2 * (size_t)table->nSlots * sizeof(int32_t))) == NULL)
+			return 0;
+		table->slots = slots;
+		table->nSlots *= 2;
+		memset(table->slots, -1, table->nSlots * sizeof(int32_t));
+		for (i = 0; i < table->count; i++)
+		{
+			for (slot = (table->addresses[i] * 0x9E3779B1U) & (table->nSlots - 1);
+				 table->slots[slot] >= 0; slot = (slot + 1) & (table->nSlots - 1))
+				;
+			table->slots[slot] = (int32_t)i;
+		}
+	}
+
+	for (slot = (address * 0x9E3779B1U) & (table->nSlots - 1); table->slots[slot] >= 0;
+		 slot = (slot + 1) & (table->nSlots - 1))
+	{
+		if (table->addresses[table->slots[slot]] == address)
+		{
+			*id = (uint32_t)table->slots[slot];
+			return 1;
+		}
+	}
+
+	if (table->count == table->capacity)
+	{
+		if ((addresses = realloc(table->addresses, (table->capacity ? 2 * (size_t)table->capacity
+													: 1024) * sizeof(uint32_t))) == NULL)
+			return 0;
+		table->addresses = addresses;
+		table->capacity = table->capacity ? 2 * table->capacity : 1024;
+	}
+	table->addresses[table->count] = address;
+	table->slots[slot] = (int32_t)table->count;
+	*id = table->count++;
+	return 1;
+}
+
+static int compareAddresses(const void * a, const void * b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int comparePairs(const void * a, const void * b)
+{
+	const CallPair * x = a;
+	const CallPair * y = b;
+
+	if (x->first != y->first)
+		return x->first < y->first ? -1 : 1;
+	return (x->second > y->second) - (x->second < y->second);
+}
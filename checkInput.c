@@ -0,0 +1,131 @@
+/*
+ * checkInput
+ *
+ * This file implements the --check option: find out whether the input
+ * is well formed, and how many lines are bad or unknown, without
+ * formatting or echoing anything.  It is meant as a quick gate before
+ * a file is accepted for further processing.
+ *
+ * int checkInput(LineReader * reader)
+ *   Classifies each line as
+ *      valid     32 '0'/'1' characters that decode to an instruction in
+ *                the table
+ *      unknown   32 '0'/'1' characters whose opcode (or funct) is not in
+ *                the table
+ *      bad       anything else, as verifyMIPSInstruction would reject it
+ *   With --max-errors n it stops after the nth bad or unknown line;
+ *   otherwise it reads the whole input.
+ *   Output: The first --show (default 10) bad or unknown lines, e.g.
+ *              Line 17: unknown instruction
+ *              Line 42: not 32 binary digits
+ *           then the totals, e.g.
+ *              Checked 1000000 lines: 999998 valid, 1 bad, 1 unknown
+ *           Nothing is printed to stderr for the bad lines.
+ *   Returns: the exit status for main:
+ *              0  every line is valid
+ *              2  some lines are bad
+ *              3  every line is well formed, but some are unknown
+ *            (1 is left for the usual fatal errors, such as a file that
+ *            cannot be opened.)
+ *
+ * Implementation:
+ *      The line length comes from the line reader, so there is no
+ *      strlen.  A line of the right length is checked and packed 8
+ *      characters at a time: one mask and compare tells whether all 8
+ *      bytes are '0' or '1', and a multiply gathers their low bits into
+ *      a byte.  Then findInstruction classifies the word with its
+ *      opcode and funct tables.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+
+#include "disassembler.h"
+
+#define INSTR_CHARS		32
+#define DEFAULT_SHOW	10
+
+static int packLine(const char * line, unsigned int * word);
+
+int checkInput(LineReader * reader)
+{
+	unsigned long show = options.show > 0 ? options.show : DEFAULT_SHOW;
+	unsigned long shown = 0;
+	long valid = 0;
+	long bad = 0;
+	long unknown = 0;
+	unsigned int word;
+	char * input;
+	int length;
+	int lineNum = 0;
+	const char * problem;
+
+	while ((input = readLine(reader, &length)) != NULL)
+	{
+		lineNum++;
+
+		if (length != INSTR_CHARS || !packLine(input, &word))
+		{
+			bad++;
+			problem = "not 32 binary digits";
+		}
+		else if (findInstruction(word) == NULL)
+		{
+			unknown++;
+			problem = "unknown instruction";
+		}
+		else
+		{
+			valid++;
+			continue;
+		}
+
+		if (shown++ < show)
+			printf("Line %d: %s\n", lineNum, problem);
+
+		if (options.maxErrors > 0 && (unsigned long)(bad + unknown) >= options.maxErrors)
+		{
+			printf("Stopped at line %d after %ld errors\n", lineNum, bad + unknown);
+			break;
+		}
+	}
+
+	printf("Checked %d lines: %ld valid, %ld bad, %ld unknown\n",
+		   lineNum, valid, bad, unknown);
+
+	closeLineReader(reader);
+	return bad > 0 ? 2 : unknown > 0 ? 3 : 0;
+}
+
+/* Packs 32 '0'/'1' characters into *word.  Returns 0 if any other
+ * character is found.
+ */
+static int packLine(const char * line, unsigned int * word)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	uint64_t chars;
+	unsigned int packed = 0;
+	int i;
+
+	for (i = 0; i < INSTR_CHARS; i += 8)
+	{
+		memcpy(&chars, line + i, sizeof(chars));
+		if ((chars & 0xFEFEFEFEFEFEFEFEULL) != 0x3030303030303030ULL)
+			return 0;
+		/* The first character is the lowest byte; the multiply moves
+		 * the low bit of byte k to bit 63 - k.
+		 */
+		packed = (packed << 8)
+			| (unsigned int)(((chars & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56);
+	}
+
+	*word = packed;
+	return 1;
+#else
+	if (strspn(line, "01") != INSTR_CHARS)
+		return 0;
+	*word = packMIPSInstruction((char *)line);
+	return 1;
+#endif
+}
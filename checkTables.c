@@ -0,0 +1,81 @@
+/*
+ * MIPS Disassembler Lookup Table Check
+ *
+ * This program checks the constant lookup tables of instructionTable.c
+ * and getRegName.c against the tables they are written out from.  The
+ * makefile runs it before building anything else, so a table that was
+ * not updated, or a mnemonic or register name whose hash collides with
+ * another's, stops the build instead of making a lookup quietly fail.
+ *
+ * Usage:
+ *          name
+ *
+ * Output:
+ *      Nothing if the tables are right.  Otherwise a line for each wrong
+ *      lookup, and the exit status is 1.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "printFuncs.h"
+#include "mipsInstructions.h"
+
+extern char * regArray[];		/* getRegName.c */
+int getRegNbr (const char * name);
+
+int main(void)
+{
+	const InstrInfo * expected;
+	const InstrInfo * found;
+	unsigned int opcode, funct, word;
+	int failed = 0;
+	int i;
+
+	/* Each opcode, and each funct of opcode 0, finds its table entry. */
+	for (opcode = 0; opcode < 64; opcode++)
+	{
+		for (funct = 0; funct < (opcode == 0 ? 64U : 1U); funct++)
+		{
+			word = opcode << 26 | funct;
+			expected = NULL;
+			for (i = 0; i < INSTRUCTION_COUNT; i++)
+			{
+				if (instructionTable[i].opcode == (int)opcode
+					&& (opcode != 0 || instructionTable[i].funct == (int)funct))
+					expected = &instructionTable[i];
+			}
+			if ((found = findInstruction(word)) != expected)
+			{
+				fprintf(stderr, "Error: opcode %u funct %u finds %s, not %s; update "
+						"opcodeIndex and functIndex.\n", opcode, funct,
+						found ? found->name : "nothing", expected ? expected->name : "nothing");
+				failed = 1;
+			}
+		}
+	}
+
+	/* Each mnemonic and register name has a slot of its own. */
+	for (i = 0; i < INSTRUCTION_COUNT; i++)
+	{
+		if (findInstructionByName(instructionTable[i].name) != &instructionTable[i])
+		{
+			fprintf(stderr, "Error: Mnemonic %s is not found; update nameSlots, or "
+					"choose MNEMONIC_HASH again if it collides.\n", instructionTable[i].name);
+			failed = 1;
+		}
+	}
+	for (i = 0; i < 32; i++)
+	{
+		if (getRegNbr(regArray[i]) != i)
+		{
+			fprintf(stderr, "Error: Register %s is not found; update regSlots, or "
+					"choose REGISTER_HASH again if it collides.\n", regArray[i]);
+			failed = 1;
+		}
+	}
+
+	return failed;
+}
@@ -0,0 +1,435 @@
+/*
+ * columnStore
+ *
+ * This file implements the --store and --query options.  The column
+ * store holds the decoded fields of a program's instructions with one
+ * array per field (opcode, funct, rs, rt, rd, shamt, imm and target,
+ * plus the input line of each instruction), so a question about the
+ * program reads only the fields it asks about instead of disassembling
+ * the whole input again.  A store can be saved to a file and mapped
+ * back into memory later.
+ *
+ * int storeInstructions(LineReader * reader, const char * path)
+ *   Reads the whole program and saves its column store in path.
+ *   Returns: the exit status for main.
+ *
+ * int queryInstructions(LineReader * reader, const char * pattern,
+ *                       const char * path)
+ *   Prints the instructions that match pattern, which has the same form
+ *   as for --match (see matchInstructions.c), e.g.
+ *          mnemonic=lw,rs=$gp      loads with base register $gp
+ *          mnemonic=slt,rd=$at     slt instructions that write $at
+ *   With --count only the number of matches is printed.  The store is
+ *   loaded from path if it is not NULL (reader is not used and may be
+ *   NULL), and is built from the input otherwise.
+ *   Returns: the exit status for main.
+ *
+ * int buildColumnStore(const Program * program, const char * path,
+ *                      ColumnStore * store)
+ *   Post-condition: store holds the fields of program's instructions;
+ *                   if path is not NULL they are also in the file path
+ *   Returns: 1, or 0 (after printing an error message) on failure.
+ *
+ * int loadColumnStore(const char * path, ColumnStore * store)
+ *   Maps the store saved in path into memory (read only).
+ *   Returns: 1, or 0 (after printing an error message) if path cannot
+ *            be read or is not a column store.
+ *
+ * void closeColumnStore(ColumnStore * store)
+ *   Frees or unmaps the memory of a built or loaded store.
+ *
+ * unsigned int storedWord(const ColumnStore * store, int index)
+ *   Returns: instruction index, put back together from its fields.
+ *
+ * int queryColumnStore(const ColumnStore * store, unsigned int mask,
+ *                      unsigned int value,
+ *                      void (*visit)(const ColumnStore * store, int index))
+ *   Calls visit (unless it is NULL) with the index of every instruction
+ *   w for which (w & mask) == value, in order.
+ *   Returns: the number of such instructions.
+ *
+ * File layout:
+ *      A 16 byte header (the magic "MIPSCOL1", then the number of
+ *      instructions and the base address as 32-bit numbers), followed by
+ *      the columns lineNums, target (32 bits each), imm (16 bits), and
+ *      opcode, funct, rs, rt, rd and shamt (8 bits), each starting on a
+ *      64 byte boundary and padded with zeros to a multiple of 4096
+ *      entries.  Numbers are in the byte order of the machine
+ *      that wrote the file.
+ *
+ * Implementation:
+ *      The (mask, value) pair of a pattern is split into one test per
+ *      column.  opcode, rs and rt cover the top 16 bits of a word; the
+ *      low 16 bits are tested on funct alone when that is all the
+ *      pattern asks about (as for mnemonic=add) and on imm otherwise, so
+ *      a query reads at most four columns, and only those it needs.
+ *      They are scanned QUERY_BLOCK instructions at a time: each test is
+ *      a simple loop ANDing one column into a byte of flags per
+ *      instruction, and the flags stay in the cache between tests.
+ *      Because the columns are padded to whole blocks the loops have a
+ *      fixed count, which lets the compiler vectorize them at -O2.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "disassembler.h"
+#include "columnStore.h"
+
+#define STORE_MAGIC		"MIPSCOL1"
+#define STORE_ALIGN		64
+#define QUERY_BLOCK		4096	/* instructions tested at a time */
+
+typedef struct
+{
+	char magic[8];
+	uint32_t count;
+	uint32_t base;
+} StoreHeader;
+
+/* The columns, in the order they are laid out. */
+enum { COL_LINE, COL_TARGET, COL_IMM, COL_OPCODE, COL_FUNCT,
+	   COL_RS, COL_RT, COL_RD, COL_SHAMT, COLUMNS };
+
+static const size_t columnWidth[COLUMNS] = { 4, 4, 2, 1, 1, 1, 1, 1, 1 };
+
+typedef struct
+{
+	const void * column;
+	unsigned int mask;
+	unsigned int value;
+} ColumnTest;
+
+static size_t layoutStore(int count, size_t offsets[]);
+static void pointColumns(ColumnStore * store);
+static void testBytes(const uint8_t * restrict column, unsigned char * restrict flags,
+					  unsigned int mask, unsigned int value);
+static void testHalves(const uint16_t * restrict column, unsigned char * restrict flags,
+					   unsigned int mask, unsigned int value);
+static void printHit(const ColumnStore * store, int index);
+
+int storeInstructions(LineReader * reader, const char * path)
+{
+	Program program;
+	ColumnStore store;
+	int status = 1;
+
+	if (!loadProgram(reader, &program))
+	{
+		return 1;
+	}
+
+	if (buildColumnStore(&program, path, &store))
+	{
+		printf("Stored %d instructions in %s\n", store.count, path);
+		closeColumnStore(&store);
+		status = 0;
+	}
+
+	freeProgram(&program);
+	return status;
+}
+
+int queryInstructions(LineReader * reader, const char * pattern, const char * path)
+{
+	Program program;
+	ColumnStore store;
+	unsigned int mask;
+	unsigned int value;
+	int found;
+
+	if (!compileMatchPattern(pattern, &mask, &value))
+	{
+		return 1;
+	}
+
+	if (path != NULL)
+	{
+		if (!loadColumnStore(path, &store))
+			return 1;
+	}
+	else
+	{
+		if (!loadProgram(reader, &program))
+			return 1;
+		found = buildColumnStore(&program, NULL, &store);
+		freeProgram(&program);
+		if (!found)
+			return 1;
+	}
+	printDebug("Query mask 0x%08x, value 0x%08x\n", mask, value);
+
+	found = queryColumnStore(&store, mask, value, options.count ? NULL : printHit);
+	if (options.count)
+	{
+		printf("%d\n", found);
+	}
+
+	closeColumnStore(&store);
+	return 0;
+}
+
+int buildColumnStore(const Program * program, const char * path, ColumnStore * store)
+{
+	size_t offsets[COLUMNS];
+	StoreHeader * header;
+	int32_t * lineNums;
+	uint32_t * target;
+	uint16_t * imm;
+	uint8_t * opcode, * funct, * rs, * rt, * rd, * shamt;
+	unsigned int word;
+	int fd;
+	int i;
+
+	store->count = program->count;
+	store->base = program->base;
+	store->size = layoutStore(program->count, offsets);
+	store->mapped = (path != NULL);
+
+	if (path == NULL)
+	{
+		store->memory = aligned_alloc(STORE_ALIGN, store->size);
+		if (store->memory != NULL)
+			memset(store->memory, 0, store->size);
+	}
+	else
+	{
+		if ((fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0
+			|| ftruncate(fd, (off_t)store->size) != 0)
+		{
+			printError("Error: Cannot write the column store %s.\n", path);
+			if (fd >= 0)
+				close(fd);
+			return 0;
+		}
+		store->memory = mmap(NULL, store->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (store->memory == MAP_FAILED)
+			store->memory = NULL;
+	}
+	if (store->memory == NULL)
+	{
+		printError("Error: Not enough memory for the column store.\n");
+		return 0;
+	}
+
+	header = store->memory;
+	memcpy(header->magic, STORE_MAGIC, sizeof(header->magic));
+	header->count = (uint32_t)store->count;
+	header->base = store->base;
+
+	lineNums = (int32_t *)((char *)store->memory + offsets[COL_LINE]);
+	target = (uint32_t *)((char *)store->memory + offsets[COL_TARGET]);
+	imm = (uint16_t *)((char *)store->memory + offsets[COL_IMM]);
+	opcode = (uint8_t *)store->memory + offsets[COL_OPCODE];
+	funct = (uint8_t *)store->memory + offsets[COL_FUNCT];
+	rs = (uint8_t *)store->memory + offsets[COL_RS];
+	rt = (uint8_t *)store->memory + offsets[COL_RT];
+	rd = (uint8_t *)store->memory + offsets[COL_RD];
+	shamt = (uint8_t *)store->memory + offsets[COL_SHAMT];
+
+	for (i = 0; i < program->count; i++)
+	{
+		word = program->words[i];
+		lineNums[i] = program->lineNums[i];
+		target[i] = TARGET(word);
+		imm[i] = (uint16_t)IMM(word);
+		opcode[i] = (uint8_t)OPCODE(word);
+		funct[i] = (uint8_t)FUNCT(word);
+		rs[i] = (uint8_t)RS(word);
+		rt[i] = (uint8_t)RT(word);
+		rd[i] = (uint8_t)RD(word);
+		shamt[i] = (uint8_t)SHAMT(word);
+	}
+
+	pointColumns(store);
+	return 1;
+}
+
+int loadColumnStore(const char * path, ColumnStore * store)
+{
+	size_t offsets[COLUMNS];
+	StoreHeader header;
+	struct stat info;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY)) < 0 || fstat(fd, &info) != 0)
+	{
+		printError("Error: Cannot open the column store %s.\n", path);
+		if (fd >= 0)
+			close(fd);
+		return 0;
+	}
+
+	if (read(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)
+		|| memcmp(header.magic, STORE_MAGIC, sizeof(header.magic)) != SAME
+		|| header.count > (uint32_t)0x7FFFFFFF
+		|| layoutStore((int)header.count, offsets) != (size_t)info.st_size)
+	{
+		printError("Error: %s is not a column store.\n", path);
+		close(fd);
+		return 0;
+	}
+
+	store->count = (int)header.count;
+	store->base = header.base;
+	store->size = (size_t)info.st_size;
+	store->mapped = 1;
+	store->memory = mmap(NULL, store->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (store->memory == MAP_FAILED)
+	{
+		printError("Error: Cannot map the column store %s.\n", path);
+		return 0;
+	}
+
+	pointColumns(store);
+	return 1;
+}
+
+void closeColumnStore(ColumnStore * store)
+{
+	if (store->mapped)
+		munmap(store->memory, store->size);
+	else
+		free(store->memory);
+	store->memory = NULL;
+}
+
+unsigned int storedWord(const ColumnStore * store, int index)
+{
+	return ((unsigned int)store->opcode[index] << 26) | ((unsigned int)store->rs[index] << 21)
+		| ((unsigned int)store->rt[index] << 16) | store->imm[index];
+}
+
+int queryColumnStore(const ColumnStore * store, unsigned int mask, unsigned int value,
+					 void (*visit)(const ColumnStore * store, int index))
+{
+	static unsigned char flags[QUERY_BLOCK];
+	ColumnTest tests[4];
+	int nTests = 0;
+	int found = 0;
+	int start, n, i, t;
+
+	if (mask >> 26)
+		tests[nTests++] = (ColumnTest){ store->opcode, mask >> 26, value >> 26 };
+	if (RS(mask))
+		tests[nTests++] = (ColumnTest){ store->rs, RS(mask), RS(value) };
+	if (RT(mask))
+		tests[nTests++] = (ColumnTest){ store->rt, RT(mask), RT(value) };
+	if (IMM(mask) & ~0x3FU)
+		tests[nTests++] = (ColumnTest){ store->imm, IMM(mask), IMM(value) };
+	else if (FUNCT(mask))
+		tests[nTests++] = (ColumnTest){ store->funct, FUNCT(mask), FUNCT(value) };
+
+	for (start = 0; start < store->count; start += QUERY_BLOCK)
+	{
+		n = store->count - start < QUERY_BLOCK ? store->count - start : QUERY_BLOCK;
+		memset(flags, 1, QUERY_BLOCK);
+
+		for (t = 0; t < nTests; t++)
+		{
+			if (tests[t].column == store->imm)
+				testHalves(store->imm + start, flags, tests[t].mask, tests[t].value);
+			else
+				testBytes((const uint8_t *)tests[t].column + start, flags,
+						  tests[t].mask, tests[t].value);
+		}
+
+		if (visit == NULL)
+		{
+			memset(flags + n, 0, QUERY_BLOCK - (size_t)n);
+			for (i = 0; i < QUERY_BLOCK; i++)
+				found += flags[i];
+			continue;
+		}
+		for (i = 0; i < n; i++)
+		{
+			if (flags[i])
+			{
+				visit(store, start + i);
+				found++;
+			}
+		}
+	}
+
+	return found;
+}
+
+/* Clears the flag of every instruction in a block whose byte column
+ * fails the test.  The columns are padded to whole blocks, so the loop
+ * always runs QUERY_BLOCK times.
+ */
+static void testBytes(const uint8_t * restrict column, unsigned char * restrict flags,
+					  unsigned int mask, unsigned int value)
+{
+	uint8_t m = (uint8_t)mask;
+	uint8_t v = (uint8_t)value;
+	int i;
+
+	for (i = 0; i < QUERY_BLOCK; i++)
+		flags[i] &= (uint8_t)((column[i] & m) == v);
+}
+
+/* The same for the 16-bit imm column. */
+static void testHalves(const uint16_t * restrict column, unsigned char * restrict flags,
+					   unsigned int mask, unsigned int value)
+{
+	uint16_t m = (uint16_t)mask;
+	uint16_t v = (uint16_t)value;
+	int i;
+
+	for (i = 0; i < QUERY_BLOCK; i++)
+		flags[i] &= (uint8_t)((column[i] & m) == v);
+}
+
+static void printHit(const ColumnStore * store, int index)
+{
+	char text[FORMAT_LIMIT];
+
+	if (formatInstruction(storedWord(store, index), text) < 0)
+		incrementErrorCount();
+	printf("Line %d: %s\n", store->lineNums[index], text);
+	checkErrorCount();
+}
+
+/* Fills in the offset of each column and returns the size of the store.
+ * Each column has room for a whole number of query blocks.
+ */
+static size_t layoutStore(int count, size_t offsets[])
+{
+	size_t size = sizeof(StoreHeader);
+	size_t padded = ((size_t)count + QUERY_BLOCK - 1) / QUERY_BLOCK * QUERY_BLOCK;
+	int c;
+
+	for (c = 0; c < COLUMNS; c++)
+	{
+		size = (size + STORE_ALIGN - 1) & ~(size_t)(STORE_ALIGN - 1);
+		offsets[c] = size;
+		size += columnWidth[c] * padded;
+	}
+
+	return (size + STORE_ALIGN - 1) & ~(size_t)(STORE_ALIGN - 1);
+}
+
+/* Points the column pointers of store into its memory. */
+static void pointColumns(ColumnStore * store)
+{
+	size_t offsets[COLUMNS];
+	const char * memory = store->memory;
+
+	layoutStore(store->count, offsets);
+	store->lineNums = (const int32_t *)(memory + offsets[COL_LINE]);
+	store->target = (const uint32_t *)(memory + offsets[COL_TARGET]);
+	store->imm = (const uint16_t *)(memory + offsets[COL_IMM]);
+	store->opcode = (const uint8_t *)(memory + offsets[COL_OPCODE]);
+	store->funct = (const uint8_t *)(memory + offsets[COL_FUNCT]);
+	store->rs = (const uint8_t *)(memory + offsets[COL_RS]);
+	store->rt = (const uint8_t *)(memory + offsets[COL_RT]);
+	store->rd = (const uint8_t *)(memory + offsets[COL_RD]);
+	store->shamt = (const uint8_t *)(memory + offsets[COL_SHAMT]);
+}
@@ -0,0 +1,39 @@
+/*
+ * This file provides the column store, which keeps each field of the
+ * decoded instructions in its own array, and the signatures for building,
+ * saving, loading and querying it (see columnStore.c).
+ */
+
+#ifndef _COLUMN_STORE_H
+#define _COLUMN_STORE_H
+
+#include <stdint.h>
+
+#include "program.h"
+
+typedef struct
+{
+	int count;					/* number of instructions */
+	unsigned int base;			/* address of the first one (--base) */
+	const int32_t * lineNums;	/* input line of each instruction */
+	const uint8_t * opcode;
+	const uint8_t * funct;
+	const uint8_t * rs;
+	const uint8_t * rt;
+	const uint8_t * rd;
+	const uint8_t * shamt;
+	const uint16_t * imm;
+	const uint32_t * target;
+	void * memory;				/* the header and all the columns */
+	size_t size;				/* bytes at memory */
+	int mapped;					/* 1 if memory is a mapping of a file */
+} ColumnStore;
+
+int buildColumnStore(const Program * program, const char * path, ColumnStore * store);
+int loadColumnStore(const char * path, ColumnStore * store);
+void closeColumnStore(ColumnStore * store);
+unsigned int storedWord(const ColumnStore * store, int index);
+int queryColumnStore(const ColumnStore * store, unsigned int mask, unsigned int value,
+					 void (*visit)(const ColumnStore * store, int index));
+
+#endif
@@ -0,0 +1,435 @@
+/*
+ * compressOutput
+ *
+ * This function makes the disassembler write its output compressed, so
+ * a listing that is archived does not need a separate compressor and a
+ * pipe to it, and takes a fraction of the disk writes: listings repeat
+ * the same few instructions and line formats over and over.
+ *
+ * int compressOutput(const char * path)
+ *   Post-condition: everything printed on stdout from now on is
+ *                   compressed into the file path: gzip if path ends in
+ *                   ".gz", zstd if it ends in ".zst" (when compiled with
+ *                   HAVE_ZSTD).  The file is finished when the program
+ *                   exits, by returning from main or by calling exit.
+ *   Returns: 1, or 0 (after printing an error message) if path has
+ *            another ending, cannot be created, or there is not enough
+ *            memory for the blocks.
+ *
+ * Implementation:
+ *      stdout is replaced by a stream made with fopencookie, whose write
+ *      function copies the data into OUTPUT_BLOCK byte blocks.  A full
+ *      block is handed to the compression threads and the next free one
+ *      is filled, so decoding and compression overlap; if the threads
+ *      fall behind, the writer waits for a block to come free.
+ *          gzip    --threads threads (one per CPU by default) each
+ *                  compress a whole block into a gzip member of its own,
+ *                  as pigz does; gunzip, and this program's own input
+ *                  (see decompressInput.c), read the members one after
+ *                  the other as one stream.  deflate looks back only 32 KB,
+ *                  so the blocks lose little by not sharing a history.
+ *                  Level 1 is used: the default level makes a listing
+ *                  about a third smaller, but is about seven times
+ *                  slower, and would hold the decoding up.
+ *          zstd    one thread feeds the blocks to a single zstd stream,
+ *                  which runs --threads workers of its own.
+ *      Each block's compressed data is kept with it, and whichever thread
+ *      finds the oldest block compressed writes it, so the file is written
+ *      in order.  An atexit handler flushes the stream, hands over the
+ *      last block, waits for the threads to finish the file, and exits
+ *      with status 1 if it could not be written or compressed (a block
+ *      that could not be compressed, because of zlib or zstd or memory,
+ *      fails the file like a failed write), removing the broken file.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#define _GNU_SOURCE		/* for fopencookie */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "disassembler.h"
+
+#define OUTPUT_BLOCK	(1 << 20)	/* bytes compressed at a time */
+#define MAX_COMPRESSORS	64			/* most compression threads */
+#define GZIP_LEVEL		1
+#define ZSTD_LEVEL		3
+
+typedef struct
+{
+	unsigned char * data;
+	size_t length;
+	int last;					/* 1 for the last block of the output */
+	unsigned char * out;		/* its compressed data */
+	size_t outLength;
+	size_t outSize;
+	int compressed;				/* 1 when out holds it all */
+} Block;
+
+typedef struct
+{
+	const char * path;
+	int fd;
+	int zstd;					/* 1 for zstd, 0 for gzip */
+	Block * blocks;
+	int nBlocks;
+	size_t used;				/* bytes in the block being filled */
+	unsigned long produced;		/* blocks handed to the threads */
+	unsigned long taken;		/* blocks a thread has started on */
+	unsigned long consumed;		/* blocks written to the file */
+	int writing;				/* 1 while a thread is writing */
+	int finished;				/* 1 when no more blocks will come */
+	int failed;					/* errno of a failed write or compression, or -1 */
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	pthread_t threads[MAX_COMPRESSORS];
+	int nThreads;
+#ifdef HAVE_ZSTD
+	ZSTD_CCtx * cctx;
+#endif
+} Compressor;
+
+static Compressor compressor;
+
+static ssize_t writeOutput(void * cookie, const char * data, size_t size);
+static void handOver(Compressor * c, int last);
+static void finishOutput(void);
+static void * compressThread(void * arg);
+static int gzipBlock(z_stream * z, Block * block);
+#ifdef HAVE_ZSTD
+static int zstdBlock(ZSTD_CCtx * cctx, Block * block);
+#endif
+static void writeBlocks(Compressor * c);
+
+int compressOutput(const char * path)
+{
+	Compressor * c = &compressor;
+	cookie_io_functions_t functions = { NULL, writeOutput, NULL, NULL };
+	const char * suffix = strrchr(path, '.');
+	long nThreads = (long)options.threads;
+	FILE * out;
+	int i;
+
+	if (suffix != NULL && strcmp(suffix, ".gz") == SAME)
+		c->zstd = 0;
+	else if (suffix != NULL && strcmp(suffix, ".zst") == SAME)
+	{
+#ifdef HAVE_ZSTD
+		c->zstd = 1;
+#else
+		printError("Error: zstd output was not compiled in (make ZSTD=1); use a .gz file.\n");
+		return 0;
+#endif
+	}
+	else
+	{
+		printError("Error: --out needs a file name ending in .gz or .zst.\n");
+		return 0;
+	}
+
+	if ((c->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0)
+	{
+		printError("Error: Cannot create file %s.\n", path);
+		return 0;
+	}
+	c->path = path;
+	c->failed = -1;
+
+	if (nThreads <= 0)
+		nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThreads < 1)
+		nThreads = 1;
+	if (nThreads > MAX_COMPRESSORS)
+		nThreads = MAX_COMPRESSORS;
+#ifdef HAVE_ZSTD
+	if (c->zstd)
+	{
+		if ((c->cctx = ZSTD_createCCtx()) == NULL)
+		{
+			printError("Error: Not enough memory for compressed output.\n");
+			close(c->fd);
+			unlink(path);
+			return 0;
+		}
+		ZSTD_CCtx_setParameter(c->cctx, ZSTD_c_compressionLevel, ZSTD_LEVEL);
+		if (nThreads > 1)		/* fails harmlessly if libzstd has no threads */
+			ZSTD_CCtx_setParameter(c->cctx, ZSTD_c_nbWorkers, (int)nThreads);
+		nThreads = 1;			/* one thread feeds the stream */
+	}
+#endif
+
+	/* A block for each thread, one being filled and one written. */
+	c->nBlocks = (int)nThreads + 2;
+	if ((c->blocks = calloc((size_t)c->nBlocks, sizeof(Block))) == NULL)
+	{
+		printError("Error: Not enough memory for compressed output.\n");
+		close(c->fd);
+		unlink(path);
+		return 0;
+	}
+	for (i = 0; i < c->nBlocks; i++)
+	{
+		if ((c->blocks[i].data = malloc(OUTPUT_BLOCK)) == NULL)
+		{
+			printError("Error: Not enough memory for compressed output.\n");
+			while (i > 0)
+				free(c->blocks[--i].data);
+			free(c->blocks);
+			close(c->fd);
+			unlink(path);
+			return 0;
+		}
+	}
+
+	pthread_mutex_init(&c->lock, NULL);
+	pthread_cond_init(&c->changed, NULL);
+	for (c->nThreads = 0; c->nThreads < nThreads; c->nThreads++)
+	{
+		if (pthread_create(&c->threads[c->nThreads], NULL, compressThread, c) != 0)
+			break;
+	}
+	if (c->nThreads == 0 || (out = fopencookie(c, "w", functions)) == NULL)
+	{
+		printError("Error: Cannot set up compressed output.\n");
+		unlink(path);
+		return 0;
+	}
+
+	setvbuf(out, NULL, _IOFBF, 1 << 16);
+	fflush(stdout);
+	stdout = out;
+	atexit(finishOutput);
+	return 1;
+}
+
+/* The stream's write function: copies data into the blocks. */
+static ssize_t writeOutput(void * cookie, const char * data, size_t size)
+{
+	Compressor * c = cookie;
+	Block * block;
+	size_t left = size;
+	size_t room;
+
+	while (left > 0)
+	{
+		block = &c->blocks[c->produced % (unsigned long)c->nBlocks];
+		room = OUTPUT_BLOCK - c->used;
+		if (room > left)
+			room = left;
+		memcpy(block->data + c->used, data, room);
+		c->used += room;
+		data += room;
+		left -= room;
+		if (c->used == OUTPUT_BLOCK)
+			handOver(c, 0);
+	}
+	return (ssize_t)size;
+}
+
+/* Hands the block being filled to the threads, and waits for the next
+ * one to be free.
+ */
+static void handOver(Compressor * c, int last)
+{
+	Block * block = &c->blocks[c->produced % (unsigned long)c->nBlocks];
+
+	pthread_mutex_lock(&c->lock);
+	block->length = c->used;
+	block->last = last;
+	block->outLength = 0;
+	block->compressed = 0;
+	c->produced++;
+	c->finished = last;
+	pthread_cond_broadcast(&c->changed);
+	while (c->produced - c->consumed >= (unsigned long)c->nBlocks)
+		pthread_cond_wait(&c->changed, &c->lock);
+	pthread_mutex_unlock(&c->lock);
+	c->used = 0;
+}
+
+static void finishOutput(void)
+{
+	Compressor * c = &compressor;
+	int i;
+
+	fflush(stdout);
+	handOver(c, 1);			/* the last block, even if empty, ends the stream */
+	for (i = 0; i < c->nThreads; i++)
+		pthread_join(c->threads[i], NULL);
+
+	if (close(c->fd) != 0 && c->failed < 0)
+		c->failed = errno;
+	if (c->failed >= 0)
+	{
+		fprintf(stderr, "Error: Cannot write file %s: %s.\n", c->path, strerror(c->failed));
+		unlink(c->path);
+		_exit(1);
+	}
+}
+
+static void * compressThread(void * arg)
+{
+	Compressor * c = arg;
+	Block * block;
+	z_stream z;
+	int ready;					/* 1 if z was set up */
+	int ok;
+
+	memset(&z, 0, sizeof(z));
+	ready = !c->zstd
+		&& deflateInit2(&z, GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+
+	pthread_mutex_lock(&c->lock);
+	for (;;)
+	{
+		while (c->taken == c->produced && !c->finished)
+			pthread_cond_wait(&c->changed, &c->lock);
+		if (c->taken == c->produced)
+			break;
+
+		block = &c->blocks[c->taken++ % (unsigned long)c->nBlocks];
+		pthread_mutex_unlock(&c->lock);
+#ifdef HAVE_ZSTD
+		if (c->zstd)
+			ok = zstdBlock(c->cctx, block);
+		else
+#endif
+			ok = ready && gzipBlock(&z, block);
+
+		/* Blocks are still taken and passed along after a failure, so
+		 * the writer never waits for them; none is written.
+		 */
+		pthread_mutex_lock(&c->lock);
+		if (!ok && c->failed < 0)
+			c->failed = EIO;
+		block->compressed = 1;
+		writeBlocks(c);
+	}
+	pthread_mutex_unlock(&c->lock);
+
+	if (ready)
+		deflateEnd(&z);
+#ifdef HAVE_ZSTD
+	else
+		ZSTD_freeCCtx(c->cctx);
+#endif
+	return NULL;
+}
+
+/* Compresses block into a gzip member of its own.  Returns 0 if there is
+ * not enough memory for it or deflate fails.
+ */
+static int gzipBlock(z_stream * z, Block * block)
+{
+	size_t bound = deflateBound(z, block->length);
+
+	if (block->outSize < bound)
+	{
+		free(block->out);
+		block->outSize = bound;
+		if ((block->out = malloc(bound)) == NULL)
+		{
+			block->outSize = 0;
+			return 0;
+		}
+	}
+
+	if (deflateReset(z) != Z_OK)
+		return 0;
+	z->next_in = block->data;
+	z->avail_in = (uInt)block->length;
+	z->next_out = block->out;
+	z->avail_out = (uInt)block->outSize;
+	if (deflate(z, Z_FINISH) != Z_STREAM_END)		/* the bound leaves room for all of it */
+		return 0;
+	block->outLength = block->outSize - z->avail_out;
+	return 1;
+}
+
+#ifdef HAVE_ZSTD
+/* Adds block to the zstd stream, ending the stream with the last block.
+ * Returns 0 if zstd fails.
+ */
+static int zstdBlock(ZSTD_CCtx * cctx, Block * block)
+{
+	ZSTD_inBuffer in = { block->data, block->length, 0 };
+	ZSTD_outBuffer out;
+	size_t remaining;
+	unsigned char * grown;
+
+	do
+	{
+		if (block->outSize - block->outLength < OUTPUT_BLOCK / 2)
+		{
+			if ((grown = realloc(block->out, block->outSize + OUTPUT_BLOCK)) == NULL)
+				return 0;
+			block->out = grown;
+			block->outSize += OUTPUT_BLOCK;
+		}
+		out.dst = block->out;
+		out.size = block->outSize;
+		out.pos = block->outLength;
+		remaining = ZSTD_compressStream2(cctx, &out, &in,
+										 block->last ? ZSTD_e_end : ZSTD_e_continue);
+		if (ZSTD_isError(remaining))
+			return 0;
+		block->outLength = out.pos;
+	} while (in.pos < in.size || (block->last && remaining != 0));
+	return 1;
+}
+#endif
+
+/* Writes the compressed blocks that are next in the file, unless another
+ * thread is doing so.  Called with the lock held; it is let go while the
+ * data is written.
+ */
+static void writeBlocks(Compressor * c)
+{
+	Block * block;
+	const unsigned char * data;
+	size_t length;
+	ssize_t written;
+	int failed;
+
+	while (!c->writing && c->consumed < c->produced
+		   && (block = &c->blocks[c->consumed % (unsigned long)c->nBlocks])->compressed)
+	{
+		c->writing = 1;
+		failed = c->failed;
+		pthread_mutex_unlock(&c->lock);
+
+		data = block->out;
+		length = block->outLength;
+		while (length > 0 && failed < 0)
+		{
+			written = write(c->fd, data, length);
+			if (written < 0 && errno == EINTR)
+				continue;
+			if (written < 0)
+				failed = errno;
+			else
+			{
+				data += written;
+				length -= (size_t)written;
+			}
+		}
+
+		pthread_mutex_lock(&c->lock);
+		if (c->failed < 0)
+			c->failed = failed;
+		block->compressed = 0;
+		c->consumed++;
+		c->writing = 0;
+		pthread_cond_broadcast(&c->changed);
+	}
+}
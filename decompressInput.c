@@ -0,0 +1,310 @@
+/*
+ * decompressInput
+ *
+ * These functions let the disassembler read compressed input as if it
+ * were plain text, so archived dumps can be read without decompressing
+ * them to disk first.  The line reader (lineReader.c) uses them when it
+ * opens its input.
+ *
+ * int isCompressed(const unsigned char * data, size_t length)
+ *   Returns: 1 if data starts with the gzip magic bytes (1f 8b) or the
+ *            zstd magic bytes (28 b5 2f fd), 0 otherwise.
+ *
+ * int decompressInput(int fd, const unsigned char * prefix, size_t length)
+ *   Pre-condition:  prefix holds the first length bytes read from fd,
+ *                   and isCompressed(prefix, length) is 1
+ *   Returns: a file descriptor from which the decompressed data can be
+ *            read, or -1 (after printing an error message) if that
+ *            cannot be set up.
+ *
+ * int decompressFailed(void)
+ *   Returns: 1 if the data could not all be decompressed (it is corrupt
+ *            or ends too soon, or there was not enough memory), 0
+ *            otherwise.  Set before the pipe is closed, so a reader that
+ *            has seen the end of the pipe gets the final answer.
+ *
+ * Implementation:
+ *      decompressInput starts a thread that decompresses the prefix and
+ *      then the rest of fd, read in large blocks (with zlib, or with
+ *      libzstd when compiled with HAVE_ZSTD), and writes the result into
+ *      a pipe.  The read end of the pipe is returned, so decompression
+ *      runs on its own thread and overlaps with decoding.  gzip files
+ *      made of several members (e.g. by cat) are handled.  The end of
+ *      the pipe looks the same whether or not decompression succeeded,
+ *      so the thread also records a failure in a flag, which the line
+ *      reader checks when it reaches the end of the pipe.  The flag is
+ *      static rather than in the reader, since the thread may outlive a
+ *      reader that stops early.
+ *
+ * Creation Date:  10/19/2026
+ *
+ * Modifications:
+ *		10/19/2026: Works on file descriptors for the block line reader.
+ */
+
+#define _GNU_SOURCE		/* for F_SETPIPE_SZ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "printFuncs.h"
+
+#define BLOCK_SIZE (1 << 20)		/* bytes read or written at a time */
+
+typedef struct
+{
+	int    source;				/* compressed input */
+	int    fd;					/* write end of the pipe */
+	unsigned char * prefix;		/* data already read from source */
+	size_t prefixLength;
+} Decompressor;
+
+static int failed = 0;			/* set by the thread, read with decompressFailed */
+
+static void * decompressThread(void * arg);
+static int writeAll(int fd, const unsigned char * data, size_t length);
+static size_t readBlock(int fd, unsigned char * data);
+static int inflateStream(Decompressor * d, unsigned char * in, unsigned char * out, size_t have);
+#ifdef HAVE_ZSTD
+static int zstdStream(Decompressor * d, unsigned char * in, unsigned char * out, size_t have);
+#endif
+
+int isCompressed(const unsigned char * data, size_t length)
+{
+	if (length >= 2 && data[0] == 0x1f && data[1] == 0x8b)
+		return 1;
+
+	return length >= 4 && data[0] == 0x28 && data[1] == 0xb5
+		&& data[2] == 0x2f && data[3] == 0xfd;
+}
+
+int decompressInput(int fd, const unsigned char * prefix, size_t length)
+{
+	Decompressor * d;
+	pthread_t thread;
+	int fds[2];
+
+	if (pipe(fds) != 0)
+	{
+		printError("Error: Cannot create a pipe for decompression.\n");
+		return -1;
+	}
+#ifdef F_SETPIPE_SZ
+	fcntl(fds[1], F_SETPIPE_SZ, BLOCK_SIZE);	/* fewer, larger transfers */
+#endif
+
+	if ((d = malloc(sizeof(Decompressor))) == NULL
+		|| (d->prefix = malloc(length)) == NULL)
+	{
+		printError("Error: Not enough memory for decompression.\n");
+		close(fds[0]);
+		close(fds[1]);
+		free(d);
+		return -1;
+	}
+	d->source = fd;
+	d->fd = fds[1];
+	d->prefixLength = length;
+	memcpy(d->prefix, prefix, length);
+
+	if (pthread_create(&thread, NULL, decompressThread, d) != 0)
+	{
+		printError("Error: Cannot start the decompression thread.\n");
+		close(fds[0]);
+		close(fds[1]);
+		free(d->prefix);
+		free(d);
+		return -1;
+	}
+	pthread_detach(thread);
+
+	return fds[0];
+}
+
+int decompressFailed(void)
+{
+	return __atomic_load_n(&failed, __ATOMIC_ACQUIRE);
+}
+
+static void * decompressThread(void * arg)
+{
+	Decompressor * d = arg;
+	size_t have = d->prefixLength;
+	/* The prefix may be longer than a block, if the reader needed more
+	 * than one read to see the magic bytes.
+	 */
+	unsigned char * in = malloc(have > BLOCK_SIZE ? have : BLOCK_SIZE);
+	unsigned char * out = malloc(BLOCK_SIZE);
+	int ok = 0;
+
+	if (in == NULL || out == NULL)
+	{
+		printError("Error: Not enough memory for decompression.\n");
+	}
+	else
+	{
+		memcpy(in, d->prefix, have);
+		if (in[0] == 0x1f)
+		{
+			ok = inflateStream(d, in, out, have);
+		}
+		else
+		{
+#ifdef HAVE_ZSTD
+			ok = zstdStream(d, in, out, have);
+#else
+			printError("Error: Input is zstd compressed, but zstd support was not compiled in.\n");
+#endif
+		}
+	}
+
+	if (!ok)
+		__atomic_store_n(&failed, 1, __ATOMIC_RELEASE);
+	close(d->fd);
+	free(in);
+	free(out);
+	free(d->prefix);
+	free(d);
+	return NULL;
+}
+
+static int inflateStream(Decompressor * d, unsigned char * in, unsigned char * out, size_t have)
+{
+	z_stream z;
+	int status = Z_OK;
+
+	memset(&z, 0, sizeof(z));
+	if (inflateInit2(&z, 15 + 16) != Z_OK)	/* 15 bit window, gzip header */
+	{
+		printError("Error: Cannot start gzip decompression.\n");
+		return 0;
+	}
+
+	z.next_in = in;
+	z.avail_in = (uInt)have;
+
+	while (z.avail_in > 0)
+	{
+		do
+		{
+			z.next_out = out;
+			z.avail_out = BLOCK_SIZE;
+			status = inflate(&z, Z_NO_FLUSH);
+
+			if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+			{
+				printError("Error: Compressed input is corrupt (%s).\n",
+						   z.msg ? z.msg : "gzip");
+				inflateEnd(&z);
+				return 0;
+			}
+			if (!writeAll(d->fd, out, BLOCK_SIZE - z.avail_out))
+			{
+				inflateEnd(&z);
+				return 0;
+			}
+		} while (z.avail_out == 0);
+
+		if (status == Z_STREAM_END)
+			inflateReset(&z);			/* another gzip member may follow */
+
+		if (z.avail_in == 0)
+		{
+			z.next_in = in;
+			z.avail_in = (uInt)readBlock(d->source, in);
+		}
+	}
+
+	if (status != Z_STREAM_END)
+		printError("Error: Compressed input ends unexpectedly.\n");
+
+	inflateEnd(&z);
+	return status == Z_STREAM_END;
+}
+
+#ifdef HAVE_ZSTD
+static int zstdStream(Decompressor * d, unsigned char * in, unsigned char * out, size_t have)
+{
+	ZSTD_DStream * z = ZSTD_createDStream();
+	ZSTD_inBuffer input = { in, have, 0 };
+	ZSTD_outBuffer output;
+	size_t result = 0;
+
+	if (z == NULL)
+	{
+		printError("Error: Cannot start zstd decompression.\n");
+		return 0;
+	}
+
+	while (input.size > 0)
+	{
+		while (input.pos < input.size)
+		{
+			output.dst = out;
+			output.size = BLOCK_SIZE;
+			output.pos = 0;
+			result = ZSTD_decompressStream(z, &output, &input);
+
+			if (ZSTD_isError(result))
+			{
+				printError("Error: Compressed input is corrupt (%s).\n",
+						   ZSTD_getErrorName(result));
+				ZSTD_freeDStream(z);
+				return 0;
+			}
+			if (!writeAll(d->fd, out, output.pos))
+			{
+				ZSTD_freeDStream(z);
+				return 0;
+			}
+		}
+
+		input.size = readBlock(d->source, in);
+		input.pos = 0;
+	}
+
+	if (result != 0)
+		printError("Error: Compressed input ends unexpectedly.\n");
+
+	ZSTD_freeDStream(z);
+	return result == 0;
+}
+#endif
+
+/* Returns 0 if the reader has gone away (closed its end of the pipe). */
+static int writeAll(int fd, const unsigned char * data, size_t length)
+{
+	ssize_t written;
+
+	while (length > 0)
+	{
+		if ((written = write(fd, data, length)) <= 0)
+			return 0;
+		data += written;
+		length -= (size_t)written;
+	}
+
+	return 1;
+}
+
+/* Reads up to BLOCK_SIZE bytes; returns 0 at end of file or on error. */
+static size_t readBlock(int fd, unsigned char * data)
+{
+	ssize_t got;
+
+	do
+	{
+		got = read(fd, data, BLOCK_SIZE);
+	} while (got < 0 && errno == EINTR);
+
+	return got > 0 ? (size_t)got : 0;
+}
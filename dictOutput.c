@@ -0,0 +1,430 @@
+/*
+ * dictOutput
+ *
+ * These functions save the disassembler's listing in a compact form and
+ * print it again: real code uses a small set of encodings over and over,
+ * so each distinct instruction and its text is kept once, and every line
+ * is just a number saying which one it is.
+ *
+ * int writeDictionary(LineReader * reader, const char * path)
+ *   Reads the whole input and saves its listing in the file path, then
+ *   prints how many lines and distinct instructions it holds and how
+ *   many bytes that took.
+ *   Returns: the exit status for main (0, or 1 if path cannot be written).
+ *
+ * int expandDictionary(const char * path)
+ *   Prints the listing saved in path exactly as the main loop would have
+ *   printed it from the original input: the same lines on stdout, the
+ *   same errors on stderr, stopping at the same error limit.
+ *   Returns: the exit status for main (0, or 1 if path cannot be read or
+ *            is not a saved listing).
+ *
+ * File layout:
+ *      The magic "MIPSDCT1", then
+ *          index stream    for each valid line, the number of its
+ *                          instruction in the dictionary, as a varint
+ *                          (7 bits a byte, low bits first)
+ *          dictionary      for each distinct instruction, in order of
+ *                          first use: the word (32 bits), a byte that is
+ *                          1 if its text is an error, and its text,
+ *                          ending in a null byte
+ *          error bitmap    a bit per line (low bit first), set for lines
+ *                          that are not 32 '0's and '1's
+ *          bad lines       the text of each of those lines, ending in a
+ *                          null byte
+ *      and a DictTrailer giving where each part starts and how many lines
+ *      and instructions there are.  Numbers are in the byte order of the
+ *      machine that wrote the file.  The trailer comes last so the file
+ *      is written in one pass.
+ *
+ * Implementation:
+ *      Each distinct word is looked up in an open-addressing hash table
+ *      and formatted only the first time it is seen; its text goes into an
+ *      arena (see arena.c).  The index stream is written through a large
+ *      stdio buffer as the lines are read, so only the dictionary, the
+ *      bitmap (a bit per line) and the text of bad lines are held in
+ *      memory.  Most lines cost one or two bytes of output, against about
+ *      70 for the listing itself, and each distinct word is formatted
+ *      once instead of once per line.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "disassembler.h"
+
+#define DICT_MAGIC	"MIPSDCT1"
+#define INSTR_CHARS	32
+#define OUT_BUFFER	(1 << 20)		/* stdio buffer for the saved file */
+
+typedef struct
+{
+	uint64_t dictOffset;		/* the dictionary */
+	uint64_t bitmapOffset;		/* the error bitmap */
+	uint64_t badOffset;			/* the bad lines */
+	uint64_t endOffset;			/* this trailer */
+	uint32_t nLines;
+	uint32_t nEntries;
+	char magic[8];
+} DictTrailer;
+
+typedef struct
+{
+	unsigned int * words;		/* word of each entry */
+	const char ** texts;		/* its formatted text */
+	unsigned char * errors;		/* 1 if formatting it was an error */
+	unsigned int count;
+	unsigned int capacity;
+	int32_t * slots;			/* hash table of entries, -1 if free */
+	unsigned int nSlots;		/* a power of 2 */
+	Arena arena;
+} Dictionary;
+
+static int64_t entryOf(Dictionary * dict, unsigned int word);
+static int growSlots(Dictionary * dict);
+static void freeDictionary(Dictionary * dict);
+static unsigned int slotOf(unsigned int word, unsigned int nSlots);
+static int isInstructionLine(const char * input);
+
+int writeDictionary(LineReader * reader, const char * path)
+{
+	Dictionary dict;
+	DictTrailer trailer;
+	FILE * out;
+	char * input = NULL;
+	int length;
+	uint32_t lineNum = 0;
+	unsigned char * bitmap = NULL, * moreBitmap;
+	size_t bitmapSize = 0;
+	char * bad = NULL, * moreBad;
+	size_t badSize = 0, badCapacity = 0;
+	unsigned char varint[5];
+	int64_t entry;
+	uint32_t index;
+	unsigned int i;
+	int n;
+
+	if ((out = fopen(path, "wb")) == NULL)
+	{
+		printError("Error: Cannot write %s.\n", path);
+		closeLineReader(reader);
+		return 1;
+	}
+	setvbuf(out, NULL, _IOFBF, OUT_BUFFER);
+	fwrite(DICT_MAGIC, 1, 8, out);
+
+	memset(&dict, 0, sizeof(dict));
+	initArena(&dict.arena, 0);
+	dict.nSlots = 1024;
+	if ((dict.slots = malloc(dict.nSlots * sizeof(int32_t))) != NULL)
+		memset(dict.slots, -1, dict.nSlots * sizeof(int32_t));
+
+	while (dict.slots != NULL && (input = readLine(reader, &length)) != NULL)
+	{
+		if (lineNum / 8 >= bitmapSize)
+		{
+			if ((moreBitmap = realloc(bitmap, bitmapSize ? 2 * bitmapSize : 65536)) == NULL)
+				break;
+			bitmap = moreBitmap;
+			memset(bitmap + bitmapSize, 0, bitmapSize ? bitmapSize : 65536);
+			bitmapSize = bitmapSize ? 2 * bitmapSize : 65536;
+		}
+
+		if (!isInstructionLine(input))
+		{
+			/* Kept as it is, for verifyMIPSInstruction to report later. */
+			bitmap[lineNum / 8] |= (unsigned char)(1 << (lineNum % 8));
+			length = (int)strlen(input) + 1;
+			if (badSize + (size_t)length > badCapacity)
+			{
+				badCapacity = badCapacity ? 2 * badCapacity : 65536;
+				while (badSize + (size_t)length > badCapacity)
+					badCapacity *= 2;
+				if ((moreBad = realloc(bad, badCapacity)) == NULL)
+					break;
+				bad = moreBad;
+			}
+			memcpy(bad + badSize, input, (size_t)length);
+			badSize += (size_t)length;
+			lineNum++;
+			continue;
+		}
+
+		if ((entry = entryOf(&dict, packMIPSInstruction(input))) < 0)
+			break;
+		for (index = (uint32_t)entry, n = 0; index >= 0x80; index >>= 7)
+			varint[n++] = (unsigned char)(index | 0x80);
+		varint[n++] = (unsigned char)index;
+		fwrite(varint, 1, (size_t)n, out);
+		lineNum++;
+	}
+	if (input != NULL || dict.slots == NULL)
+	{
+		printError("Error: Not enough memory for the saved listing.\n");
+		fclose(out);
+		closeLineReader(reader);
+		freeDictionary(&dict);
+		free(bitmap);
+		free(bad);
+		return 1;
+	}
+	closeLineReader(reader);
+
+	trailer.dictOffset = (uint64_t)ftell(out);
+	for (i = 0; i < dict.count; i++)
+	{
+		fwrite(&dict.words[i], sizeof(unsigned int), 1, out);
+		fwrite(&dict.errors[i], 1, 1, out);
+		fwrite(dict.texts[i], 1, strlen(dict.texts[i]) + 1, out);
+	}
+	trailer.bitmapOffset = (uint64_t)ftell(out);
+	fwrite(bitmap, 1, (lineNum + 7) / 8, out);
+	trailer.badOffset = (uint64_t)ftell(out);
+	fwrite(bad, 1, badSize, out);
+	trailer.endOffset = (uint64_t)ftell(out);
+	trailer.nLines = lineNum;
+	trailer.nEntries = dict.count;
+	memcpy(trailer.magic, DICT_MAGIC, sizeof(trailer.magic));
+	fwrite(&trailer, sizeof(trailer), 1, out);
+
+	if (ferror(out) | fclose(out))
+	{
+		printError("Error: Cannot write %s.\n", path);
+		return 1;
+	}
+
+	printf("Saved %u lines as %u distinct instructions in %llu bytes (%.2f per line)\n",
+		   lineNum, dict.count, (unsigned long long)(trailer.endOffset + sizeof(trailer)),
+		   lineNum ? (double)(trailer.endOffset + sizeof(trailer)) / lineNum : 0.0);
+
+	freeDictionary(&dict);
+	free(bitmap);
+	free(bad);
+	return 0;
+}
+
+int expandDictionary(const char * path)
+{
+	static const char bits[2] = { '0', '1' };
+	struct stat info;
+	const DictTrailer * trailer;
+	const unsigned char * file;
+	const unsigned char * p;
+	const unsigned char * streamEnd;
+	const unsigned char * bitmap;
+	const char * bad;
+	const char * badEnd;
+	unsigned int * words = NULL;
+	const char ** texts = NULL;
+	unsigned char * errors = NULL;
+	char input[LINE_LIMIT + 1];
+	uint32_t lineNum, index, nEntries;
+	int shift, i, fd;
+	int valid = 0;
+	int damaged;
+
+	if ((fd = open(path, O_RDONLY)) < 0 || fstat(fd, &info) != 0)
+	{
+		printError("Error: Cannot read %s.\n", path);
+		return 1;
+	}
+	if ((size_t)info.st_size < 8 + sizeof(DictTrailer)
+		|| (file = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+	{
+		printError("Error: %s is not a saved listing.\n", path);
+		close(fd);
+		return 1;
+	}
+	close(fd);
+
+	trailer = (const DictTrailer *)(file + info.st_size - sizeof(DictTrailer));
+	if (memcmp(file, DICT_MAGIC, 8) == SAME
+		&& memcmp(trailer->magic, DICT_MAGIC, sizeof(trailer->magic)) == SAME
+		&& trailer->endOffset == (uint64_t)info.st_size - sizeof(DictTrailer)
+		&& 8 <= trailer->dictOffset && trailer->dictOffset <= trailer->bitmapOffset
+		&& trailer->bitmapOffset + (trailer->nLines + 7ULL) / 8 == trailer->badOffset
+		&& trailer->badOffset <= trailer->endOffset)
+	{
+		/* Find each entry of the dictionary. */
+		nEntries = trailer->nEntries;
+		words = malloc((nEntries + 1) * sizeof(unsigned int));
+		texts = malloc((nEntries + 1) * sizeof(char *));
+		errors = malloc(nEntries + 1);
+		if (words == NULL || texts == NULL || errors == NULL)
+		{
+			printError("Error: Not enough memory for the dictionary of %s.\n", path);
+			free(words);
+			free(texts);
+			free(errors);
+			munmap((void *)file, (size_t)info.st_size);
+			return 1;
+		}
+		p = file + trailer->dictOffset;
+		for (index = 0; index < nEntries && p + 5 < file + trailer->bitmapOffset; index++)
+		{
+			memcpy(&words[index], p, sizeof(unsigned int));
+			errors[index] = p[4];
+			texts[index] = (const char *)p + 5;
+			p = memchr(p + 5, '\0', (size_t)(file + trailer->bitmapOffset - (p + 5)));
+			if (p == NULL)
+				break;
+			p++;
+		}
+		valid = index == nEntries && (nEntries == 0 || p == file + trailer->bitmapOffset);
+	}
+	if (!valid)
+	{
+		printError("Error: %s is not a saved listing.\n", path);
+		free(words);
+		free(texts);
+		free(errors);
+		munmap((void *)file, (size_t)info.st_size);
+		return 1;
+	}
+
+	p = file + 8;
+	streamEnd = file + trailer->dictOffset;
+	bitmap = file + trailer->bitmapOffset;
+	bad = (const char *)file + trailer->badOffset;
+	badEnd = (const char *)file + trailer->endOffset;
+	input[INSTR_CHARS] = '\0';
+
+	for (lineNum = 0; lineNum < trailer->nLines; lineNum++)
+	{
+		if (bitmap[lineNum / 8] & (1 << (lineNum % 8)))
+		{
+			i = (int)strnlen(bad, (size_t)(badEnd - bad));
+			if (bad + i == badEnd || i > LINE_LIMIT)
+				break;
+			memcpy(input, bad, (size_t)i + 1);
+			bad += i + 1;
+			printf("\nLine %u: %s\n", lineNum + 1, input);
+			verifyMIPSInstruction((int)lineNum + 1, input);
+			input[INSTR_CHARS] = '\0';
+			continue;
+		}
+
+		for (index = 0, shift = 0; p < streamEnd && shift < 35; shift += 7)
+		{
+			index |= (uint32_t)(*p & 0x7F) << shift;
+			if (!(*p++ & 0x80))
+				break;
+		}
+		if (index >= trailer->nEntries || p > streamEnd)
+			break;
+
+		for (i = 0; i < INSTR_CHARS; i++)
+			input[i] = bits[(words[index] >> (INSTR_CHARS - 1 - i)) & 1];
+		printf("\nLine %u: %s\nLine %u: %s\n", lineNum + 1, input, lineNum + 1, texts[index]);
+		if (errors[index])
+		{
+			incrementErrorCount();
+		}
+		checkErrorCount();
+	}
+
+	damaged = lineNum < trailer->nLines;
+	if (damaged)
+	{
+		printError("Error: %s is damaged after line %u.\n", path, lineNum);
+	}
+
+	free(words);
+	free(texts);
+	free(errors);
+	munmap((void *)file, (size_t)info.st_size);
+	return damaged;
+}
+
+/* Returns the entry of word in the dictionary, adding it (and formatting
+ * its text) if it is new, or -1 if there is no memory for it.
+ */
+static int64_t entryOf(Dictionary * dict, unsigned int word)
+{
+	char text[FORMAT_LIMIT];
+	unsigned int slot;
+	unsigned int capacity;
+	void * more;
+
+	for (slot = slotOf(word, dict->nSlots); dict->slots[slot] >= 0;
+		 slot = (slot + 1) & (dict->nSlots - 1))
+	{
+		if (dict->words[dict->slots[slot]] == word)
+			return dict->slots[slot];
+	}
+
+	if (dict->count == dict->capacity)
+	{
+		/* Each array keeps what it has if a later one cannot grow. */
+		capacity = dict->capacity ? 2 * dict->capacity : 1024;
+		if ((more = realloc(dict->words, capacity * sizeof(unsigned int))) == NULL)
+			return -1;
+		dict->words = more;
+		if ((more = realloc(dict->texts, capacity * sizeof(char *))) == NULL)
+			return -1;
+		dict->texts = more;
+		if ((more = realloc(dict->errors, capacity)) == NULL)
+			return -1;
+		dict->errors = more;
+		dict->capacity = capacity;
+	}
+	dict->words[dict->count] = word;
+	dict->errors[dict->count] = formatInstruction(word, text) < 0;
+	if ((dict->texts[dict->count] = arenaString(&dict->arena, text)) == NULL)
+		return -1;
+	dict->slots[slot] = (int32_t)dict->count;
+
+	if (2 * ++dict->count > dict->nSlots && !growSlots(dict))
+		return -1;
+	return dict->count - 1;
+}
+
+/* Doubles the hash table and puts the entries back in it.  Returns 0,
+ * leaving the table as it was, if there is not enough memory.
+ */
+static int growSlots(Dictionary * dict)
+{
+	int32_t * slots;
+	unsigned int slot, i;
+
+	if ((slots = realloc(dict->slots, 2 * (size_t)dict->nSlots * sizeof(int32_t))) == NULL)
+		return 0;
+	dict->slots = slots;
+	dict->nSlots *= 2;
+	memset(dict->slots, -1, dict->nSlots * sizeof(int32_t));
+	for (i = 0; i < dict->count; i++)
+	{
+		for (slot = slotOf(dict->words[i], dict->nSlots); dict->slots[slot] >= 0;
+			 slot = (slot + 1) & (dict->nSlots - 1))
+			;
+		dict->slots[slot] = (int32_t)i;
+	}
+	return 1;
+}
+
+static void freeDictionary(Dictionary * dict)
+{
+	free(dict->words);
+	free(dict->texts);
+	free(dict->errors);
+	free(dict->slots);
+	freeArena(&dict->arena);
+}
+
+static unsigned int slotOf(unsigned int word, unsigned int nSlots)
+{
+	return (unsigned int)(((uint64_t)word * 0x9E3779B97F4A7C15ULL) >> 32) & (nSlots - 1);
+}
+
+/* Returns 1 if verifyMIPSInstruction would accept input (checked quietly,
+ * since bad lines are reported when the listing is expanded).
+ */
+static int isInstructionLine(const char * input)
+{
+	return strspn(input, "01") == INSTR_CHARS && input[INSTR_CHARS] == '\0';
+}
@@ -0,0 +1,444 @@
+/*
+ * diffInstructions
+ *
+ * This file implements the --diff option: compare two instruction
+ * dumps, such as two builds of the same firmware, and print only the
+ * instructions that changed, with a few unchanged ones around them.
+ *
+ * int diffInstructions(LineReader * reader, const char * oldPath)
+ *   Compares the program in oldPath (the old one) with the one read
+ *   from reader (the new one).  Both are read with the line reader, so
+ *   either may be compressed, and invalid lines are reported by
+ *   verifyMIPSInstruction and left out, as in the other modes.
+ *   Output: For each group of changes, a header giving the old and new
+ *           line where it starts, then its lines, e.g.
+ *              @@ old line 118, new line 120 @@
+ *                Line 120: addiu $sp, $sp, -32
+ *              - Line 121: lw $t0, 0($a0)
+ *              + Line 123: lw $t0, 4($a0)
+ *                Line 124: jr $ra
+ *           where "-" lines (numbered as in the old input) were removed,
+ *           "+" lines (numbered as in the new input) were added, and
+ *           the others are up to DIFF_CONTEXT unchanged instructions on
+ *           either side.  Last, the number of instructions unchanged,
+ *           removed and added.
+ *   Returns: the exit status for main, as for diff(1): 0 if the
+ *            programs are the same, 1 if they differ, 2 on trouble.
+ *
+ * Implementation:
+ *      Each input is cut into chunks: a chunk ends after a branch or
+ *      jump (the end of a basic block, see endsBasicBlock in program.c),
+ *      after DIFF_WINDOW instructions, or after a word whose hash has
+ *      its top 5 bits clear, so long runs without branches are cut in
+ *      the same places in both inputs too.  Since where a chunk ends
+ *      depends only on its contents, the chunks line up again right
+ *      after an insertion or deletion.  Each chunk gets a 64-bit FNV-1a
+ *      hash of its words.
+ *
+ *      The inputs are streamed: each keeps a queue of up to
+ *      DIFF_LOOKAHEAD chunks, refilled with readWordBlock as chunks are
+ *      used up, so memory stays bounded however large the inputs are.
+ *      While the chunks at the front of the queues are equal (the hashes
+ *      match, and then the words), both are dropped without formatting
+ *      anything.  When they differ, the new queue's chunks are put in a
+ *      hash index and the old queue is searched for the pair of equal
+ *      chunks (i, j) with the smallest i + j; the old chunks before i
+ *      were removed and the new chunks before j were added.  If no
+ *      chunk matches within the lookahead, one chunk of each is treated
+ *      as changed and the search is repeated after it.  The instructions
+ *      the removed and added chunks begin and end with in common are
+ *      trimmed off as unchanged, so a one-word change prints as one "-"
+ *      line and one "+" line.  Only the changed instructions and their
+ *      context are ever formatted.
+ *
+ *      Because the search is bounded, a single insertion or deletion
+ *      longer than about DIFF_LOOKAHEAD chunks (some 10,000 instructions
+ *      of typical code) is shown as a replacement of the text around it.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+
+#include "disassembler.h"
+
+#define DIFF_WINDOW		64		/* most instructions in a chunk */
+#define DIFF_LOOKAHEAD	1024	/* chunks searched for a match */
+#define DIFF_CONTEXT	3		/* unchanged instructions shown around changes */
+#define DIFF_READ		4096	/* words read at a time */
+#define INDEX_SIZE		4096	/* slots in the hash index (> 2 * DIFF_LOOKAHEAD) */
+
+#define WORD_CAPACITY	(2 * DIFF_LOOKAHEAD * DIFF_WINDOW + DIFF_WINDOW + DIFF_READ)
+#define CHUNK_CAPACITY	(2 * DIFF_LOOKAHEAD)
+#define FAR_AWAY		(1 << 30)	/* distance from a change at the start */
+
+typedef struct
+{
+	int start;				/* index of its first word in the side's buffer */
+	int length;
+	uint64_t hash;
+} Chunk;
+
+/* One of the two inputs. */
+typedef struct
+{
+	LineReader * reader;
+	int lineNum;			/* lines read so far */
+	int eof;
+	unsigned int * words;	/* WORD_CAPACITY words read, and their lines */
+	int * lineNums;
+	int wordCount;			/* words in the buffer */
+	int cut;				/* end of the last chunk */
+	Chunk * chunks;			/* the queue is chunks[first .. last) */
+	int first;
+	int last;
+} DiffSide;
+
+typedef struct
+{
+	unsigned int word;
+	int oldLine;
+	int newLine;
+} Unchanged;
+
+/* What has been printed so far. */
+typedef struct
+{
+	Unchanged recent[DIFF_CONTEXT];	/* the last unchanged instructions */
+	int nRecent;
+	int sinceChange;		/* unchanged instructions since the last change */
+	long same;
+	long removed;
+	long added;
+} DiffOutput;
+
+static int openSide(DiffSide * side, LineReader * reader);
+static void closeSide(DiffSide * side);
+static void fillSide(DiffSide * side);
+static int cutChunk(DiffSide * side);
+static void readMore(DiffSide * side);
+static int chunksEqual(const DiffSide * a, int i, const DiffSide * b, int j);
+static int findMatch(const DiffSide * old, const DiffSide * new, int * i, int * j);
+static void printChange(DiffOutput * out, DiffSide * old, int i, DiffSide * new, int j);
+static void printUnchanged(DiffOutput * out, unsigned int word, int oldLine, int newLine);
+static void startChange(DiffOutput * out, int oldLine, int newLine);
+static void printWord(const char * mark, int lineNum, unsigned int word);
+static int lineAt(const DiffSide * side, int index);
+
+int diffInstructions(LineReader * reader, const char * oldPath)
+{
+	static DiffOutput out;
+	DiffSide old, new;
+	FILE * fptr;
+	LineReader * oldReader;
+	int i, j, k;
+
+	if ((fptr = fopen(oldPath, "r")) == NULL)
+	{
+		printError("Error: Cannot open file %s.\n", oldPath);
+		return 2;
+	}
+	if ((oldReader = openInput(fptr)) == NULL)
+	{
+		return 2;
+	}
+	if (!openSide(&old, oldReader) || !openSide(&new, reader))
+	{
+		printError("Error: Not enough memory to compare the programs.\n");
+		return 2;
+	}
+	out.sinceChange = FAR_AWAY;
+
+	for (;;)
+	{
+		fillSide(&old);
+		fillSide(&new);
+		if (old.first == old.last && new.first == new.last)
+			break;
+
+		if (old.first < old.last && new.first < new.last
+			&& chunksEqual(&old, old.first, &new, new.first))
+		{
+			for (k = 0; k < old.chunks[old.first].length; k++)
+			{
+				printUnchanged(&out, old.words[old.chunks[old.first].start + k],
+							   old.lineNums[old.chunks[old.first].start + k],
+							   new.lineNums[new.chunks[new.first].start + k]);
+			}
+			old.first++;
+			new.first++;
+			continue;
+		}
+
+		if (old.first == old.last)
+			i = 0, j = 1;
+		else if (new.first == new.last)
+			i = 1, j = 0;
+		else if (!findMatch(&old, &new, &i, &j))
+			i = 1, j = 1;
+
+		printChange(&out, &old, i, &new, j);
+		old.first += i;
+		new.first += j;
+	}
+
+	printf("%ld instructions unchanged, %ld removed, %ld added\n",
+		   out.same, out.removed, out.added);
+
+	closeSide(&old);
+	closeSide(&new);
+	closeLineReader(oldReader);
+	return (out.removed + out.added) > 0;
+}
+
+static int openSide(DiffSide * side, LineReader * reader)
+{
+	memset(side, 0, sizeof(*side));
+	side->reader = reader;
+	side->words = malloc(WORD_CAPACITY * sizeof(unsigned int));
+	side->lineNums = malloc(WORD_CAPACITY * sizeof(int));
+	side->chunks = malloc(CHUNK_CAPACITY * sizeof(Chunk));
+
+	return side->words != NULL && side->lineNums != NULL && side->chunks != NULL;
+}
+
+static void closeSide(DiffSide * side)
+{
+	free(side->words);
+	free(side->lineNums);
+	free(side->chunks);
+}
+
+/* Queues chunks until there are DIFF_LOOKAHEAD of them or the input ends. */
+static void fillSide(DiffSide * side)
+{
+	int shift;
+	int c;
+
+	/* Move the queued chunks and their words back to the front. */
+	if (side->first >= DIFF_LOOKAHEAD)
+	{
+		shift = side->first < side->last ? side->chunks[side->first].start : side->cut;
+		memmove(side->words, side->words + shift, (side->wordCount - shift) * sizeof(unsigned int));
+		memmove(side->lineNums, side->lineNums + shift, (side->wordCount - shift) * sizeof(int));
+		memmove(side->chunks, side->chunks + side->first, (side->last - side->first) * sizeof(Chunk));
+		side->last -= side->first;
+		side->first = 0;
+		for (c = 0; c < side->last; c++)
+			side->chunks[c].start -= shift;
+		side->wordCount -= shift;
+		side->cut -= shift;
+	}
+
+	while (side->last - side->first < DIFF_LOOKAHEAD && side->last < CHUNK_CAPACITY)
+	{
+		if (cutChunk(side))
+			continue;
+		if (side->eof)
+			break;
+		readMore(side);
+	}
+}
+
+/* Queues the next chunk of the buffered words.  Returns 0 if more words
+ * must be read first to tell where it ends (or none are left).
+ */
+static int cutChunk(DiffSide * side)
+{
+	Chunk * chunk;
+	uint64_t hash = 14695981039346656037ULL;
+	unsigned int word;
+	int limit = side->cut + DIFF_WINDOW;
+	int boundary = 0;
+	int end;
+
+	if (limit > side->wordCount)
+		limit = side->wordCount;
+
+	for (end = side->cut; end < limit && !boundary; end++)
+	{
+		word = side->words[end];
+		boundary = endsBasicBlock(word) || (word * 0x9E3779B1U) >> 27 == 0;
+	}
+
+	if (end == side->cut || (!boundary && end - side->cut < DIFF_WINDOW && !side->eof))
+	{
+		return 0;
+	}
+
+	chunk = &side->chunks[side->last++];
+	chunk->start = side->cut;
+	chunk->length = end - side->cut;
+	for (; side->cut < end; side->cut++)
+		hash = (hash ^ side->words[side->cut]) * 1099511628211ULL;
+	chunk->hash = hash;
+	return 1;
+}
+
+static void readMore(DiffSide * side)
+{
+	int room = WORD_CAPACITY - side->wordCount;
+	int count;
+
+	count = readWordBlock(side->reader, side->words + side->wordCount,
+						  side->lineNums + side->wordCount,
+						  room < DIFF_READ ? room : DIFF_READ, &side->lineNum);
+	side->wordCount += count;
+	if (count == 0)
+		side->eof = 1;
+}
+
+static int chunksEqual(const DiffSide * a, int i, const DiffSide * b, int j)
+{
+	return a->chunks[i].hash == b->chunks[j].hash
+		&& a->chunks[i].length == b->chunks[j].length
+		&& memcmp(a->words + a->chunks[i].start, b->words + b->chunks[j].start,
+				  a->chunks[i].length * sizeof(unsigned int)) == SAME;
+}
+
+/* Finds the queued chunks old i and new j (counted from the fronts of the
+ * queues) that are equal and have the smallest i + j.  Returns 0 if no
+ * queued chunks are equal.
+ */
+static int findMatch(const DiffSide * old, const DiffSide * new, int * i, int * j)
+{
+	static int slots[INDEX_SIZE];		/* queue positions of new chunks, or -1 */
+	int best = FAR_AWAY;
+	int slot;
+	int a, b;
+
+	memset(slots, -1, sizeof(slots));
+	for (b = new->first; b < new->last; b++)
+	{
+		for (slot = new->chunks[b].hash & (INDEX_SIZE - 1); slots[slot] >= 0;
+			 slot = (slot + 1) & (INDEX_SIZE - 1))
+		{
+			if (new->chunks[slots[slot]].hash == new->chunks[b].hash)
+				break;			/* keep the first chunk with this hash */
+		}
+		if (slots[slot] < 0)
+			slots[slot] = b;
+	}
+
+	for (a = old->first; a < old->last && a - old->first < best; a++)
+	{
+		for (slot = old->chunks[a].hash & (INDEX_SIZE - 1); slots[slot] >= 0;
+			 slot = (slot + 1) & (INDEX_SIZE - 1))
+		{
+			b = slots[slot];
+			if (chunksEqual(old, a, new, b))
+			{
+				if ((a - old->first) + (b - new->first) < best)
+				{
+					best = (a - old->first) + (b - new->first);
+					*i = a - old->first;
+					*j = b - new->first;
+				}
+				break;
+			}
+		}
+	}
+
+	return best < FAR_AWAY;
+}
+
+/* Prints the change from the next i old chunks to the next j new ones. */
+static void printChange(DiffOutput * out, DiffSide * old, int i, DiffSide * new, int j)
+{
+	int oldStart = old->chunks[old->first].start;
+	int newStart = new->chunks[new->first].start;
+	int nOld = i > 0 ? old->chunks[old->first + i - 1].start
+			   + old->chunks[old->first + i - 1].length - oldStart : 0;
+	int nNew = j > 0 ? new->chunks[new->first + j - 1].start
+			   + new->chunks[new->first + j - 1].length - newStart : 0;
+	const unsigned int * oldWords = old->words + oldStart;
+	const unsigned int * newWords = new->words + newStart;
+	int prefix = 0;
+	int suffix = 0;
+	int k;
+
+	while (prefix < nOld && prefix < nNew && oldWords[prefix] == newWords[prefix])
+		prefix++;
+	while (suffix < nOld - prefix && suffix < nNew - prefix
+		   && oldWords[nOld - 1 - suffix] == newWords[nNew - 1 - suffix])
+		suffix++;
+
+	for (k = 0; k < prefix; k++)
+		printUnchanged(out, newWords[k], old->lineNums[oldStart + k], new->lineNums[newStart + k]);
+
+	if (prefix + suffix < nOld || prefix + suffix < nNew)
+		startChange(out, lineAt(old, oldStart + prefix), lineAt(new, newStart + prefix));
+	for (k = prefix; k < nOld - suffix; k++)
+		printWord("- ", old->lineNums[oldStart + k], oldWords[k]);
+	for (k = prefix; k < nNew - suffix; k++)
+		printWord("+ ", new->lineNums[newStart + k], newWords[k]);
+	out->removed += nOld - suffix - prefix;
+	out->added += nNew - suffix - prefix;
+
+	for (k = suffix; k > 0; k--)
+	{
+		printUnchanged(out, newWords[nNew - k], old->lineNums[oldStart + nOld - k],
+					   new->lineNums[newStart + nNew - k]);
+	}
+}
+
+/* Counts an unchanged instruction, printing it if it follows a change
+ * closely enough, and remembers it in case a change follows it.
+ */
+static void printUnchanged(DiffOutput * out, unsigned int word, int oldLine, int newLine)
+{
+	out->same++;
+	if (out->sinceChange < DIFF_CONTEXT)
+		printWord("  ", newLine, word);
+	if (out->sinceChange < FAR_AWAY)
+		out->sinceChange++;
+
+	memmove(out->recent, out->recent + 1, (DIFF_CONTEXT - 1) * sizeof(Unchanged));
+	out->recent[DIFF_CONTEXT - 1] = (Unchanged){ word, oldLine, newLine };
+	if (out->nRecent < DIFF_CONTEXT)
+		out->nRecent++;
+}
+
+/* Prints whatever context comes before a change: nothing if it is close
+ * enough to the last change that all of it was printed after that one,
+ * or else the header and the last few unchanged instructions.
+ */
+static void startChange(DiffOutput * out, int oldLine, int newLine)
+{
+	int show = out->sinceChange - DIFF_CONTEXT;
+	int k;
+
+	if (show > 0)
+	{
+		if (show > DIFF_CONTEXT || out->sinceChange == FAR_AWAY)
+		{
+			show = out->nRecent;
+			if (show > 0)
+			{
+				oldLine = out->recent[DIFF_CONTEXT - show].oldLine;
+				newLine = out->recent[DIFF_CONTEXT - show].newLine;
+			}
+			printf("@@ old line %d, new line %d @@\n", oldLine, newLine);
+		}
+		for (k = DIFF_CONTEXT - show; k < DIFF_CONTEXT; k++)
+			printWord("  ", out->recent[k].newLine, out->recent[k].word);
+	}
+
+	out->sinceChange = 0;
+}
+
+static void printWord(const char * mark, int lineNum, unsigned int word)
+{
+	char text[FORMAT_LIMIT];
+
+	formatInstruction(word, text);
+	printf("%sLine %d: %s\n", mark, lineNum, text);
+}
+
+/* The input line of a side's word at index, or of the next line to be
+ * read if there is no such word yet.
+ */
+static int lineAt(const DiffSide * side, int index)
+{
+	return index < side->wordCount ? side->lineNums[index] : side->lineNum + 1;
+}
@@ -4,11 +4,11 @@
  * This program reads lines from a file.  For each line, the program
  *      calls verifyMIPSInstruction.  If the line contains characters
  *      representing a valid binary MIPS instruction, the program 
- *		calls binToDec for various segments of the binary string to 
- *		determine the format, R, I, or J. Each of these formats has
- *		a corresponding function that will use BinToDec again to 
- *		determine the other components of the binary string (ie Registers), 
- *		and will output the corresponding MIPS Assembly code.
+ *		packs it into a 32-bit word and looks it up in the instruction
+ *		table (instructionTable.c) to determine the format, R, I, or J,
+ *		and the order of its operands.  formatInstruction then pulls the
+ *		other components out of the word (ie Registers) and outputs the
+ *		corresponding MIPS Assembly code.
  * 		The BinToDec and verifyMIPSInstruction were extensively 
  *		tested in the Disassembler Utilities PP.  For more information
  *		on the testing for those functions, see the Github page below:
@@ -26,6 +26,66 @@
  *      If no debugging choice is provided, the program prints debugging
  *      messages, or not, depending on indications in the code.
  *
+ *		Options (see process_arguments.c) select other modes:
+ *			--match pattern		print only the instructions matching
+ *								pattern (see matchInstructions.c)
+ *			--simulate			run the program (see simulator.c)
+ *			--verify-roundtrip	check that every printed instruction
+ *								assembles back to its input word
+ *								(see verifyRoundTrip.c)
+ *			--imm style			print immediates as dec (the default),
+ *								signed or hex (see formatInstruction.c)
+ *			--pseudo			print pseudo-instructions such as nop,
+ *								move and li (see pseudoInstructions.c)
+ *			--liveness report	print register def-use and liveness, per
+ *								line or as a summary (see liveness.c)
+ *			--serve path		answer requests on a Unix domain socket
+ *								until stopped (see serve.c)
+ *			--store file		save the decoded fields in a column
+ *								store (see columnStore.c)
+ *			--query pattern		print the matching instructions, from
+ *								the column store if --store is given
+ *			--diff old			print the differences between the program
+ *								in file old and the input (see
+ *								diffInstructions.c)
+ *			--collapse n		print a run of n or more identical lines
+ *								once, as a range of lines
+ *			--check				only count the valid, bad and unknown
+ *								lines (see checkInput.c)
+ *			--xref file			save a cross-reference index of registers,
+ *								targets and immediates (see xref.c)
+ *			--refs key			print the lines recorded under key, from
+ *								the index if --xref is given
+ *			--resolve			print the addresses of loads, stores and
+ *								jr that constants resolve, using --gp for
+ *								$gp (see resolveAddresses.c)
+ *			--callgraph format	print the calls between functions as
+ *								dot or csv (see callGraph.c)
+ *			--functions			print the functions found from their
+ *								prologues, returns and calls, with
+ *								their stack frames (see findFunctions.c)
+ *			--input format		read the input as bin, hex, raw, elf,
+ *								ihex, srec, memh or memb, instead of
+ *								as its first bytes look (see
+ *								sniffInput.c); images are listed with
+ *								each word at its address (see
+ *								wordReader.c)
+ *			--endian order		byte order of ihex, srec and raw
+ *								words, big (the default) or little
+ *			--max-memory n		most bytes a program loaded for
+ *								--liveness, --resolve or --store may
+ *								use (see program.c)
+ *			--memory			print how much memory that program
+ *								used, in all and per instruction
+ *			--dict file			save the listing as a dictionary of
+ *								distinct instructions and an index per
+ *								line (see dictOutput.c)
+ *			--expand file		print a listing saved with --dict
+ *			--files list		disassemble each file named in list,
+ *								reading many at once (see batchFiles.c)
+ *			--out file			write the output compressed, to file.gz
+ *								or file.zst (see compressOutput.c)
+ *
  *		Functionality is based off this table below:
  *			http://www.cs.kzoo.edu/cs230/Projects/mipsTable.html
  * Input:
@@ -60,7 +120,9 @@
  *		but there is not just a new line ('\n') at the end of a line,
  *		there is also a carriage return ('\r'). In order to account for
  *		this I simply used the same logic for removing the new line and
- *		repeated it for a carriage return.
+ *		repeated it for a carriage return.  (This is now done by the
+ *		line reader, lineReader.c, which reads the input in large blocks
+ *		and also handles empty and over-long lines.)
  *
  * Author:  Nicolas McCabe, Tim Rutledge
  *
@@ -69,26 +131,53 @@
  * Modifications: 
  * 		4/24/2018: Added disassembler functionality, and test cases.
  * 		5/4/2018:  Added a factor of 4 to the j and jal functions.
+ * 		10/19/2026: Added the --match, --simulate and --verify-roundtrip
+ * 		            modes; the formatting buffers are thread-local so the
+ * 		            round trip check can format in several threads.
+ * 		10/19/2026: Input is read with the block line reader instead of fgets.
+ * 		10/19/2026: processR, processI and processJ replaced by the
+ * 		            table-driven formatInstruction; this also fixes sltiu,
+ * 		            which was printed as "stliu".
+ * 		10/19/2026: Added the --pseudo and --liveness modes.
+ * 		10/19/2026: Added the --serve daemon mode.
+ * 		10/19/2026: Added the --store and --query column store modes.
+ * 		10/19/2026: Added the --diff mode.
+ * 		10/19/2026: Added --collapse for runs of identical lines.
+ * 		10/19/2026: Added the --check mode.
+ * 		10/19/2026: Added the --xref and --refs cross-reference modes.
+ * 		10/19/2026: Added the --resolve constant propagation mode.
+ * 		10/19/2026: Added the --callgraph mode.
+ * 		10/19/2026: Added --input for ihex, srec, memh and memb images.
+ * 		10/19/2026: The input format is sniffed unless --input gives it.
+ * 		10/19/2026: Added --max-memory and --memory for the program model.
+ * 		10/19/2026: Added --dict and --expand for dictionary-encoded listings.
+ * 		10/19/2026: Added --files for batches of files read asynchronously.
+ * 		10/19/2026: Added the --functions mode.
+ * 		10/19/2026: Added --out for compressed output.
  */
 
 /* include files go here */
 #include "disassembler.h"
 
-char* processRaw(char input[]);
-char* processR(char input[]);
-char* processI(char input[]);
-char* processJ(char input[]);
-
 const int SAME = 0;		/* useful for making strcmp readable */
 						/* e.g., if (strcmp (str1, str2) == SAME) */
 
+#define INSTR_CHARS 32		/* characters in a valid input line */
+#define IMAGE_BLOCK 4096	/* --input: words read at a time */
+
+static void printRun(const char * input, int first, int count);
+static int listImage(LineReader * reader);
+
 int main(int argc, char *argv[])
 {
 	FILE * fptr;               /* file pointer */
-	char   input[BUFSIZ];      /* place to store line that is read in */
+	LineReader * reader;       /* reads fptr in large blocks */
+	char * input;              /* line that is read in */
 	int    length;             /* length of line read in */
 	int    lineNum = 0;        /* keep track of input line numbers */
-	char assembly[27];
+	char   runText[INSTR_CHARS + 1];	/* --collapse: the repeated line */
+	int    runFirst = 0;       /* line the run started on */
+	int    runCount = 0;       /* lines in the run so far */
 
 	/* Process command-line arguments (if any) -- input file name
 	 *    and/or debugging indicator (1 = on; 0 = off).
@@ -99,6 +188,140 @@ int main(int argc, char *argv[])
 		return 1;   /* Fatal error when processing arguments */
 	}
 
+	if (!setImmediateStyle(options.immStyle))
+	{
+		printError("Error: Unknown immediate style %s (use dec, signed or hex).\n",
+				   options.immStyle);
+		return 1;
+	}
+
+	if (options.out != NULL && !compressOutput(options.out))
+	{
+		return 1;
+	}
+
+	if (options.serve != NULL)
+	{
+		fclose(fptr);		/* requests come from the socket instead */
+		return serveRequests(options.serve);
+	}
+
+	if (options.query != NULL && options.store != NULL)
+	{
+		fclose(fptr);		/* the saved store is queried instead */
+		return queryInstructions(NULL, options.query, options.store);
+	}
+
+	if (options.refs != NULL && options.xref != NULL)
+	{
+		fclose(fptr);		/* the saved index is used instead */
+		return queryXref(NULL, options.refs, options.xref);
+	}
+
+	if (options.expand != NULL)
+	{
+		fclose(fptr);		/* the saved listing is printed instead */
+		return expandDictionary(options.expand);
+	}
+
+	if (options.files != NULL)
+	{
+		fclose(fptr);		/* the listed files are read instead */
+		return disassembleFiles(options.files);
+	}
+
+	reader = openInput(fptr);
+	if (reader == NULL)
+	{
+		return 1;   /* Fatal error when setting up the input */
+	}
+
+	if (wordSource(reader) != NULL && (options.check || options.pseudo || options.dict))
+	{
+		printError("Error: --check, --pseudo and --dict read binary lines, not images.\n");
+		return 1;
+	}
+
+	if (options.check)
+	{
+		return checkInput(reader);
+	}
+
+	if (options.matchPattern != NULL)
+	{
+		return matchInstructions(reader, options.matchPattern);
+	}
+
+	if (options.simulate)
+	{
+		return simulateProgram(reader);
+	}
+
+	if (options.verifyRoundTrip)
+	{
+		return verifyRoundTrip(reader);
+	}
+
+	if (options.pseudo)
+	{
+		return listPseudoInstructions(reader);
+	}
+
+	if (options.liveness != NULL)
+	{
+		return analyzeLiveness(reader, options.liveness);
+	}
+
+	if (options.query != NULL)
+	{
+		return queryInstructions(reader, options.query, NULL);
+	}
+
+	if (options.diff != NULL)
+	{
+		return diffInstructions(reader, options.diff);
+	}
+
+	if (options.refs != NULL)
+	{
+		return queryXref(reader, options.refs, NULL);
+	}
+
+	if (options.xref != NULL)
+	{
+		return buildXref(reader, options.xref);
+	}
+
+	if (options.resolve)
+	{
+		return resolveAddresses(reader);
+	}
+
+	if (options.callGraph != NULL)
+	{
+		return printCallGraph(reader, options.callGraph);
+	}
+
+	if (options.functions)
+	{
+		return findFunctions(reader);
+	}
+
+	if (options.store != NULL)
+	{
+		return storeInstructions(reader, options.store);
+	}
+
+	if (options.dict != NULL)
+	{
+		return writeDictionary(reader, options.dict);
+	}
+
+	if (wordSource(reader) != NULL)
+	{
+		return listImage(reader);
+	}
+
 	/* Can turn debugging on or off here (debug_on() or debug_off())
 	 * if not specified on the command line.
 	 */
@@ -107,23 +330,33 @@ int main(int argc, char *argv[])
 	 * Each line should contain a valid MIPS machine language instruction
 	 * (represented as 32 character '0's and '1's) and newline.
 	 */
-	while (fgets(input, BUFSIZ, fptr))   /* fgets returns NULL if EOF */
+	while ((input = readLine(reader, &length)) != NULL)   /* NULL if EOF */
 	{
 		lineNum++;
 
-		/* If the last character in the string is a newline or a carriage return,
-		 * "remove" it by replacing it with a null byte.
+		/* With --collapse, valid lines are held back while they repeat
+		 * the one before, and the run is printed when it ends.
 		 */
-		length = strlen(input);
-
-		if (input[length - 1] == '\n')
-		{
-			input[--length] = '\0';      /* remove; pre-decrement length */
-		}
-
-		if (input[length - 1] == '\r')
+		if (options.collapse > 0)
 		{
-			input[--length] = '\0';
+			if (runCount > 0 && length == INSTR_CHARS
+				&& memcmp(input, runText, INSTR_CHARS) == SAME)
+			{
+				runCount++;
+				continue;
+			}
+			if (runCount > 0)
+			{
+				printRun(runText, runFirst, runCount);
+				runCount = 0;
+			}
+			if (length == INSTR_CHARS && strspn(input, "01") == INSTR_CHARS)
+			{
+				memcpy(runText, input, INSTR_CHARS + 1);
+				runFirst = lineNum;
+				runCount = 1;
+				continue;
+			}
 		}
 
 		printf("\nLine %d: %s\n", lineNum, input);
@@ -136,326 +369,95 @@ int main(int argc, char *argv[])
 		 */
 		if (verifyMIPSInstruction(lineNum, input) == 1)
 		{
-			char * tempt = processRaw(input);
-			strcpy(assembly, tempt);
-			printf("Line %d: %s\n", lineNum, assembly);
+			printf("Line %d: %s\n", lineNum, processRaw(input));
 			checkErrorCount();
 		}
 	}
 
+	if (runCount > 0)
+	{
+		printRun(runText, runFirst, runCount);
+	}
+
 	/* End-of-file encountered; close the file. */
-	fclose(fptr);
+	closeLineReader(reader);
 	return 0;
 }
 
-/*Process Raw*/
-char* processRaw(char input[])
+/* Prints count copies of the valid line input, starting at line first:
+ * one at a time, as the loop in main would, if there are fewer than
+ * --collapse of them, and as a single range otherwise, e.g.
+ *      Lines 1200-98000: sll $zero, $zero, 0 x96801
+ */
+static void printRun(const char * input, int first, int count)
 {
-	printDebug("Processing MIPS...\n");
+	char text[FORMAT_LIMIT];
+	int  lineNum;
 
-	switch (binToDec(input, 0 ,5)) /* Checks the first 6 digits in the MIPS */
+	if (count < 2 || (unsigned long)count < options.collapse)
 	{
-		case 0 : /* R */
-			return processR(input);
-
-		case 2 : /* J-2 */		/* For some reason (2 || 3) was not working for the case, so they are now split up */
-			return processJ(input);
-
-		case 3 : /* J-3 */
-			return processJ(input);
+		for (lineNum = first; lineNum < first + count; lineNum++)
+		{
+			printf("\nLine %d: %s\n", lineNum, input);
+			printf("Line %d: %s\n", lineNum, processRaw((char *)input));
+			checkErrorCount();
+		}
+		return;
+	}
 
-		default : /* I */
-			return processI(input);
+	/* An unknown instruction is an error for each line, as it would be
+	 * without --collapse, so the error limit stops at the same count.
+	 */
+	if (formatInstruction(packMIPSInstruction((char *)input), text) < 0)
+	{
+		for (lineNum = 0; lineNum < count; lineNum++)
+			incrementErrorCount();
 	}
+	printf("\nLines %d-%d: %s\n", first, first + count - 1, input);
+	printf("Lines %d-%d: %s x%d\n", first, first + count - 1, text, count);
+	checkErrorCount();
 }
 
-/*Process R*/
-char* processR(char input[])
+/* Lists the words of an image (see wordReader.c), each with the
+ * address it is loaded at in place of a line number, e.g.
+ *      0x00400000: 3c011001  lui $at, 4097
+ */
+static int listImage(LineReader * reader)
 {
-	printDebug("Processing MIPS Type R...\n");
-
-	static char assemblyInst[26] = { 0 };
-	char converted[7] = { 0 };
-	char registry[6] = { 0 };
-
-	switch (binToDec(input, 26, 31))
-	{
-		case 0 :
-			strcpy(assemblyInst, "sll ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 21, 25));
-			strcat(assemblyInst, converted);						/* Shift */
-		break;
-
-		case 2 :
-			strcpy(assemblyInst, "srl ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 21, 25));
-			strcat(assemblyInst, converted);						/* Shift */
-		break;
-
-		case 8 :
-			strcpy(assemblyInst, "jr ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, registry);							/* Registry 1*/
-		break;
-
-		case 32 :
-			strcpy(assemblyInst, "add ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 33 :
-			strcpy(assemblyInst, "addu ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 34 :
-			strcpy(assemblyInst, "sub ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 35 :
-			strcpy(assemblyInst, "subu ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 36 :
-			strcpy(assemblyInst, "and ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 37 :
-			strcpy(assemblyInst, "or ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 39 :
-			strcpy(assemblyInst, "nor ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 42 :
-			strcpy(assemblyInst, "slt ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		case 43 :
-			strcpy(assemblyInst, "sltu ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 16, 20)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, registry);							/* Registry 3 */
-		break;
-
-		default :
-			strcpy(assemblyInst, "Error: Unknown Function");	/* Error */
-			incrementErrorCount();								/* Error Count ++ */
-		break;
+	static unsigned int words[IMAGE_BLOCK];
+	static unsigned int addresses[IMAGE_BLOCK];
+	char text[FORMAT_LIMIT];
+	WordReader * image = wordSource(reader);
+	int n, k;
+
+	while ((n = readWords(image, words, addresses, IMAGE_BLOCK)) > 0)
+	{
+		for (k = 0; k < n; k++)
+		{
+			if (formatInstruction(words[k], text) < 0)
+			{
+				incrementErrorCount();
+			}
+			printf("0x%08x: %08x  %s\n", addresses[k], words[k], text);
+			checkErrorCount();
+		}
 	}
 
-	printDebug("MIPS Processed.\n");
-	return assemblyInst;
+	closeWordReader(image);
+	closeLineReader(reader);
+	return 0;
 }
 
-/*Process I*/
-char* processI(char input[])
+/*Process Raw*/
+char* processRaw(char input[])
 {
-	printDebug("Processing MIPS Type I...\n");
-
-	static char assemblyInst[26] = { 0 };
-	char converted[10] = { 0 };
-	char registry[6] = { 0 };
-
-	switch (binToDec(input, 0, 5))
-	{
-		case 4 :
-			strcpy(assemblyInst, "beq ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 5 :
-			strcpy(assemblyInst, "bne ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 8 :
-			strcpy(assemblyInst, "addi ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 9 :
-			strcpy(assemblyInst, "addiu ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 10 :
-			strcpy(assemblyInst, "slti ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 11 :
-			strcpy(assemblyInst, "stliu ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 12 :
-			strcpy(assemblyInst, "andi ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 13 :
-			strcpy(assemblyInst, "ori ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 2 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 15 :
-			strcpy(assemblyInst, "lui ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, converted);						/* Integer */
-		break;
-
-		case 35 :
-			strcpy(assemblyInst, "lw ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, strcat(converted, "("));			/* Integer */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ")"));			/* Registry 2 */
-		break;
-
-		case 43 :
-			strcpy(assemblyInst, "sw ");							/* Function */
-			strcpy(registry, getRegName(binToDec(input, 11, 15)));
-			strcat(assemblyInst, strcat(registry, ", "));			/* Registry 1 */
-			sprintf(converted, "%d", binToDec(input, 16, 31));
-			strcat(assemblyInst, strcat(converted, "("));			/* Integer */
-			strcpy(registry, getRegName(binToDec(input, 6, 10)));
-			strcat(assemblyInst, strcat(registry, ")"));			/* Registry 2 */
-		break;
-
-		default :
-			strcpy(assemblyInst, "Error: Unknown OP Code");		/* Error */
-			incrementErrorCount();								/* Error Count ++ */
-		break;
-	}
-
-	printDebug("MIPS Processed.\n");
-	return assemblyInst;
-}
+	static _Thread_local char assemblyInst[FORMAT_LIMIT] = { 0 };
 
+	printDebug("Processing MIPS...\n");
 
-/*Process J*/
-char* processJ(char input[])
-{
-	printDebug("Processing MIPS Type J...\n");
-	static char assemblyInst[16] = { 0 };
-	char converted[10] = { 0 };
-
-	switch (binToDec(input, 0, 5))
-	{
-		case 2 :
-			strcpy(assemblyInst, "j ");							/* Function */
-			sprintf(converted, "%d", (binToDec(input, 6, 31)*4));
-			strcat(assemblyInst, converted);					/* Integer */
-		break;
-
-		default : /* This will only ever be 3 */
-			strcpy(assemblyInst, "jal ");						/* Function */
-			sprintf(converted, "%d", (binToDec(input, 6, 31)*4));
-			strcat(assemblyInst, converted);					/* Integer */
-		break;
+	if (formatInstruction(packMIPSInstruction(input), assemblyInst) < 0)
+	{
+		incrementErrorCount();								/* Error Count ++ */
 	}
 
 	printDebug("MIPS Processed.\n");
@@ -14,10 +14,51 @@
 
 #include "printFuncs.h"
 #include "process_arguments.h"
+#include "mipsInstructions.h"
+#include "lineReader.h"
+#include "program.h"
+#include "wordReader.h"
 
 int binToDec (char string[], int begin, int end);
 int verifyMIPSInstruction (int lineNum, char string[]);
 char * getRegName (int regNbr);
+int getRegNbr (const char * name);
+
+char * processRaw (char input[]);
+int readWordBlock (LineReader * reader, unsigned int words[], int lineNums[],
+                   int max, int * lineNum);
+int readAddressBlock (LineReader * reader, unsigned int words[],
+                      unsigned int addresses[], int lineNums[], int max,
+                      int * lineNum, unsigned int * address);
+
+int compileMatchPattern (const char * pattern, unsigned int * mask,
+                         unsigned int * value);
+int scanMatches (const unsigned int words[], int count,
+                 unsigned int mask, unsigned int value, int hits[]);
+int matchInstructions (LineReader * reader, const char * pattern);
+int simulateProgram (LineReader * reader);
+const char * assembleInstruction (const char * text, unsigned int * word,
+                                  int strict);
+int verifyRoundTrip (LineReader * reader);
+int listPseudoInstructions (LineReader * reader);
+void instructionDefUse (unsigned int word, unsigned int * def, unsigned int * use);
+int analyzeLiveness (LineReader * reader, const char * report);
+int serveRequests (const char * path);
+int storeInstructions (LineReader * reader, const char * path);
+int queryInstructions (LineReader * reader, const char * pattern,
+                       const char * path);
+int diffInstructions (LineReader * reader, const char * oldPath);
+int checkInput (LineReader * reader);
+int buildXref (LineReader * reader, const char * path);
+int queryXref (LineReader * reader, const char * key, const char * path);
+int resolveAddresses (LineReader * reader);
+int printCallGraph (LineReader * reader, const char * format);
+int findFunctions (LineReader * reader);
+int writeDictionary (LineReader * reader, const char * path);
+int expandDictionary (const char * path);
+int disassembleFiles (const char * listPath);
+int compressOutput (const char * path);
+const char * sniffInput (const unsigned char * data, size_t length, int * bigEndian);
 
 extern const int SAME;		/* useful for making strcmp readable */
                                 /* e.g., if (strcmp (str1, str2) == SAME) */
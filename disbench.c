@@ -0,0 +1,223 @@
+/*
+ * MIPS Disassembler Server Benchmark
+ *
+ * This program measures a disassembler running with --serve: several
+ * client threads each send a stream of small requests of random valid
+ * instructions and wait for each reply before sending the next.
+ *
+ * Usage:
+ *          name --socket path [ --threads n ] [ --requests n ]
+ *               [ --batch n ] [ --format text|binary ] [ 0|1 ]
+ *          --socket path   where the daemon is listening
+ *          --threads n     client connections, each on its own thread
+ *                          (default 4)
+ *          --requests n    requests sent by each client (default 10000)
+ *          --batch n       instructions per request (default 16)
+ *          --format        reply format asked for (default text)
+ *
+ * Output:
+ *      The number of requests and instructions, the elapsed time, the
+ *      throughput, and the mean, median and 99th percentile time from
+ *      sending a request to receiving its reply.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "process_arguments.h"
+#include "mipsInstructions.h"
+#include "serveProtocol.h"
+
+const int SAME = 0;		/* useful for making strcmp readable */
+						/* e.g., if (strcmp (str1, str2) == SAME) */
+
+#define MAX_THREADS 256
+
+typedef struct
+{
+	unsigned int seed;
+	unsigned long requests;
+	unsigned long batch;
+	unsigned char reply;
+	double * latencies;			/* seconds, one per request */
+	int failed;
+} Client;
+
+static void * runClient(void * arg);
+static unsigned int randomInstruction(unsigned int * seed);
+static double now(void);
+static int compareDoubles(const void * a, const void * b);
+
+int main(int argc, char *argv[])
+{
+	static Client clients[MAX_THREADS];
+	pthread_t threads[MAX_THREADS];
+	unsigned long nThreads;
+	unsigned long requests;
+	unsigned long batch;
+	unsigned long total;
+	unsigned long i, t;
+	double * latencies;
+	double start, elapsed, sum = 0;
+	unsigned char reply = 'T';
+	FILE * fptr;
+
+	fptr = process_arguments(argc, argv);
+	if (fptr == NULL)
+	{
+		return 1;
+	}
+	fclose(fptr);			/* no input is read */
+
+	if (options.socketPath == NULL)
+	{
+		printError("Error: No --socket given.\n");
+		return 1;
+	}
+	if (options.format != NULL && strcmp(options.format, "binary") == SAME)
+		reply = 'B';
+
+	nThreads = options.threads > 0 ? options.threads : 4;
+	if (nThreads > MAX_THREADS)
+		nThreads = MAX_THREADS;
+	requests = options.requests > 0 ? options.requests : 10000;
+	batch = options.batch > 0 ? options.batch : 16;
+
+	start = now();
+	for (t = 0; t < nThreads; t++)
+	{
+		clients[t].seed = (unsigned int)t * 2654435761U + 1;
+		clients[t].requests = requests;
+		clients[t].batch = batch;
+		clients[t].reply = reply;
+		clients[t].latencies = malloc(requests * sizeof(double));
+		if (clients[t].latencies == NULL)
+		{
+			printError("Error: Not enough memory for the latencies.\n");
+			return 1;
+		}
+		if (pthread_create(&threads[t], NULL, runClient, &clients[t]) != 0)
+		{
+			printError("Error: Cannot start client threads.\n");
+			return 1;
+		}
+	}
+	for (t = 0; t < nThreads; t++)
+		pthread_join(threads[t], NULL);
+	elapsed = now() - start;
+
+	/* Gather every latency to find the median and 99th percentile. */
+	total = nThreads * requests;
+	latencies = malloc(total * sizeof(double));
+	if (latencies == NULL)
+	{
+		printError("Error: Not enough memory for the latencies.\n");
+		return 1;
+	}
+	for (t = 0; t < nThreads; t++)
+	{
+		if (clients[t].failed)
+		{
+			printError("Error: A client could not finish its requests.\n");
+			return 1;
+		}
+		memcpy(latencies + t * requests, clients[t].latencies, requests * sizeof(double));
+		free(clients[t].latencies);
+	}
+	for (i = 0; i < total; i++)
+		sum += latencies[i];
+	qsort(latencies, total, sizeof(double), compareDoubles);
+
+	printf("%lu clients, %lu requests of %lu instructions in %.3f s\n",
+		   nThreads, total, batch, elapsed);
+	printf("%.0f requests/s, %.0f instructions/s\n",
+		   total / elapsed, total * batch / elapsed);
+	printf("Latency: mean %.1f us, median %.1f us, 99th percentile %.1f us\n",
+		   sum / total * 1e6, latencies[total / 2] * 1e6, latencies[total * 99 / 100] * 1e6);
+
+	free(latencies);
+	return 0;
+}
+
+static void * runClient(void * arg)
+{
+	Client * client = arg;
+	unsigned char * request = malloc(client->batch * 4);
+	unsigned char * answer = NULL;
+	size_t capacity = 0;
+	FrameHeader frame;
+	unsigned int word;
+	unsigned long r, i;
+	double sent;
+	int fd;
+
+	if (request == NULL)
+	{
+		printError("Error: Not enough memory for a request.\n");
+		client->failed = 1;
+		return NULL;
+	}
+	if ((fd = connectToServer(options.socketPath)) < 0)
+	{
+		client->failed = 1;
+		free(request);
+		return NULL;
+	}
+
+	for (r = 0; r < client->requests; r++)
+	{
+		for (i = 0; i < client->batch; i++)
+		{
+			word = randomInstruction(&client->seed);
+			request[4 * i] = (unsigned char)(word >> 24);
+			request[4 * i + 1] = (unsigned char)(word >> 16);
+			request[4 * i + 2] = (unsigned char)(word >> 8);
+			request[4 * i + 3] = (unsigned char)word;
+		}
+
+		sent = now();
+		if (!sendFrame(fd, 'W', client->reply, request, (unsigned int)(client->batch * 4))
+			|| receiveFrame(fd, &frame, &answer, &capacity) != 1 || frame.kind != 0)
+		{
+			client->failed = 1;
+			break;
+		}
+		client->latencies[r] = now() - sent;
+	}
+
+	close(fd);
+	free(request);
+	free(answer);
+	return NULL;
+}
+
+/* A random word whose opcode (and funct) are in the instruction table. */
+static unsigned int randomInstruction(unsigned int * seed)
+{
+	const InstrInfo * instr = &instructionTable[rand_r(seed) % INSTRUCTION_COUNT];
+	unsigned int word = ((unsigned int)rand_r(seed) << 16) ^ (unsigned int)rand_r(seed);
+
+	word = ((unsigned int)instr->opcode << 26) | (word & 0x3FFFFFF);
+	if (instr->format == 'R')
+		word = (word & ~0x3FU) | (unsigned int)instr->funct;
+	return word;
+}
+
+static double now(void)
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static int compareDoubles(const void * a, const void * b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
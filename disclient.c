@@ -0,0 +1,189 @@
+/*
+ * MIPS Disassembler Client
+ *
+ * This program sends instruction lines to a disassembler running with
+ * --serve and prints the replies, so a listing can be produced without
+ * starting the disassembler itself.
+ *
+ * Usage:
+ *          name --socket path [ --format text|binary ] [ --batch n ]
+ *               [ filename ] [ 0|1 ]
+ *      The filename and debugging choice are handled by
+ *      process_arguments, just as in the disassembler.
+ *          --socket path   where the daemon is listening
+ *          --format text   print each instruction as the daemon formats
+ *                          it (the default)
+ *          --format binary print the fields of each instruction's
+ *                          binary record
+ *          --batch n       lines sent per request (default 65536)
+ *
+ * Output:
+ *      "Line N: " and the reply for each input line, e.g.
+ *          Line 3: add $t0, $s2, $t0
+ *          Line 3: 0x02484020 op 0 rs 18 rt 8 rd 8 shamt 0 funct 32 index 3
+ *      Lines that are not 32 '0'/'1' characters give "Error: Invalid line"
+ *      (index 254 in binary records).
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <unistd.h>
+
+#include "process_arguments.h"
+#include "lineReader.h"
+#include "serveProtocol.h"
+
+const int SAME = 0;		/* useful for making strcmp readable */
+						/* e.g., if (strcmp (str1, str2) == SAME) */
+
+#define DEFAULT_BATCH 65536
+
+static int exchange(int fd, unsigned char reply, const unsigned char * request,
+					unsigned int length, int firstLine);
+
+int main(int argc, char *argv[])
+{
+	FILE * fptr;
+	LineReader * reader;
+	unsigned char * request;
+	unsigned char * larger;
+	size_t capacity;
+	size_t used = 0;
+	unsigned long batch;
+	unsigned char reply = 'T';
+	char * input;
+	int length;
+	int lineNum = 0;
+	int firstLine = 1;
+	int fd;
+	int status = 0;
+
+	fptr = process_arguments(argc, argv);
+	if (fptr == NULL)
+	{
+		return 1;
+	}
+
+	if (options.socketPath == NULL)
+	{
+		printError("Error: No --socket given.\n");
+		return 1;
+	}
+	if (options.format != NULL && strcmp(options.format, "binary") == SAME)
+		reply = 'B';
+	else if (options.format != NULL && strcmp(options.format, "text") != SAME)
+	{
+		printError("Error: Unknown reply format %s (use text or binary).\n", options.format);
+		return 1;
+	}
+
+	if ((fd = connectToServer(options.socketPath)) < 0)
+	{
+		return 1;
+	}
+	if ((reader = openLineReader(fptr)) == NULL)
+	{
+		return 1;
+	}
+
+	batch = options.batch > 0 ? options.batch : DEFAULT_BATCH;
+	capacity = batch * 33;
+	if ((request = malloc(capacity)) == NULL)
+	{
+		printError("Error: Not enough memory for a request.\n");
+		closeLineReader(reader);
+		close(fd);
+		return 1;
+	}
+
+	while ((input = readLine(reader, &length)) != NULL)
+	{
+		lineNum++;
+
+		if (used + (size_t)length + 1 > capacity)
+		{
+			if ((larger = realloc(request, (used + (size_t)length + 1) * 2)) == NULL)
+			{
+				printError("Error: Not enough memory for a request.\n");
+				status = 1;
+				break;
+			}
+			request = larger;
+			capacity = (used + (size_t)length + 1) * 2;
+		}
+		memcpy(request + used, input, (size_t)length);
+		used += (size_t)length;
+		request[used++] = '\n';
+
+		if ((unsigned long)(lineNum - firstLine + 1) == batch)
+		{
+			if (!exchange(fd, reply, request, (unsigned int)used, firstLine))
+			{
+				status = 1;
+				break;
+			}
+			used = 0;
+			firstLine = lineNum + 1;
+		}
+	}
+
+	if (status == 0 && used > 0 && !exchange(fd, reply, request, (unsigned int)used, firstLine))
+		status = 1;
+
+	closeLineReader(reader);
+	close(fd);
+	free(request);
+	return status;
+}
+
+/* Sends one request and prints its reply.  Returns 0 on failure. */
+static int exchange(int fd, unsigned char reply, const unsigned char * request,
+					unsigned int length, int firstLine)
+{
+	static unsigned char * answer = NULL;
+	static size_t capacity = 0;
+	FrameHeader frame;
+	int received = 0;
+	char * line;
+	char * newline;
+	const unsigned char * record;
+	unsigned int i;
+	unsigned int word;
+	int lineNum = firstLine;
+
+	if (!sendFrame(fd, 'L', reply, request, length)
+		|| (received = receiveFrame(fd, &frame, &answer, &capacity)) == 0)
+	{
+		printError("Error: Lost the connection to the server.\n");
+		return 0;
+	}
+	if (received < 0)
+		return 0;				/* receiveFrame printed the error */
+
+	if (frame.kind != 0)
+	{
+		printError("%s\n", (char *)answer);
+		return 0;
+	}
+
+	if (reply == 'T')
+	{
+		for (line = (char *)answer; (newline = strchr(line, '\n')) != NULL; line = newline + 1)
+		{
+			*newline = '\0';
+			printf("Line %d: %s\n", lineNum++, line);
+		}
+		return 1;
+	}
+
+	for (i = 0; i + SERVE_RECORD <= frame.length; i += SERVE_RECORD)
+	{
+		record = answer + i;
+		word = ((unsigned int)record[0] << 24) | ((unsigned int)record[1] << 16)
+			| ((unsigned int)record[2] << 8) | record[3];
+		printf("Line %d: 0x%08x op %d rs %d rt %d rd %d shamt %d funct %d index %d\n",
+			   lineNum++, word, record[4], record[5], record[6], record[7],
+			   record[8], record[9], record[10]);
+	}
+	return 1;
+}
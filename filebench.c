@@ -0,0 +1,235 @@
+/*
+ * MIPS Disassembler File Reading Benchmark
+ *
+ * This program measures how fast a batch of files is read and decoded
+ * with each way the asynchronous reader (asyncReader.c) can read them,
+ * so io_uring and the thread pool can be compared with plain
+ * synchronous reads on the same files.
+ *
+ * Usage:
+ *          name --files list [ --io backend|all ] [ --threads n ]
+ *               [ --cold ] [ 0|1 ]
+ *          --files list    the files to read, one name per line
+ *          --io backend    uring, threads, sync, or all of them (the
+ *                          default), one after the other
+ *          --threads n     threads for the threads backend (default 8)
+ *          --cold          drop the files from the page cache before
+ *                          each run, so the storage is measured too
+ *
+ * Output:
+ *      For each backend, the files and bytes read, the lines decoded and
+ *      how many were valid instructions, the elapsed time and the
+ *      throughput.  Each valid line is packed and formatted as the
+ *      disassembler would, so the time includes the decode stage that
+ *      the reads overlap with.  Without --cold, the first run may pay for
+ *      reading the files from the storage and later runs find them in
+ *      the page cache; run it twice, or use --cold, before comparing.
+ *      --cold asks the kernel to drop the files' clean pages, which it
+ *      may not do for all of them.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "process_arguments.h"
+#include "mipsInstructions.h"
+#include "asyncReader.h"
+
+const int SAME = 0;		/* useful for making strcmp readable */
+						/* e.g., if (strcmp (str1, str2) == SAME) */
+
+#define INSTR_CHARS 32		/* characters in a valid input line */
+
+typedef struct
+{
+	unsigned long files;
+	unsigned long bytes;
+	unsigned long lines;
+	unsigned long valid;
+	unsigned long failed;
+	unsigned int check;			/* mixes every decoded text, so none is skipped */
+} Totals;
+
+static int runBackend(char * const paths[], int nPaths, const char * backend,
+					  Totals * totals);
+static void decodeLine(const char * line, size_t length, Totals * totals);
+static void dropFromCache(char * const paths[], int nPaths);
+static double now(void);
+
+int main(int argc, char *argv[])
+{
+	static const char * const backends[] = { "uring", "threads", "sync" };
+	Arena names;
+	char ** paths;
+	int nPaths;
+	Totals totals;
+	double start, elapsed;
+	int status = 0;
+	int b;
+	FILE * fptr;
+
+	fptr = process_arguments(argc, argv);
+	if (fptr == NULL)
+	{
+		return 1;
+	}
+	fclose(fptr);			/* the files come from --files */
+
+	if (options.files == NULL)
+	{
+		printError("Error: No --files given.\n");
+		return 1;
+	}
+
+	initArena(&names, 0);
+	if ((paths = readPathList(options.files, &names, &nPaths)) == NULL)
+	{
+		freeArena(&names);
+		return 1;
+	}
+
+	for (b = 0; b < 3; b++)
+	{
+		if (options.io != NULL && strcmp(options.io, "all") != SAME
+			&& strcmp(options.io, backends[b]) != SAME)
+			continue;
+
+		if (options.cold)
+			dropFromCache(paths, nPaths);
+		memset(&totals, 0, sizeof(totals));
+		start = now();
+		if (!runBackend(paths, nPaths, backends[b], &totals))
+		{
+			status = 1;
+			continue;
+		}
+		elapsed = now() - start;
+
+		printf("%-8s %lu files (%lu unreadable), %lu bytes, %lu lines (%lu valid) "
+			   "in %.3f s: %.0f files/s, %.1f MB/s\n",
+			   backends[b], totals.files, totals.failed, totals.bytes, totals.lines,
+			   totals.valid, elapsed, totals.files / elapsed,
+			   totals.bytes / elapsed / 1e6);
+		printDebug("Check %08x\n", totals.check);
+	}
+
+	free(paths);
+	freeArena(&names);
+	return status;
+}
+
+/* Reads and decodes all the files with backend, adding to totals.
+ * Returns: 1, or 0 (after printing an error message) if it failed.
+ */
+static int runBackend(char * const paths[], int nPaths, const char * backend,
+					  Totals * totals)
+{
+	AsyncReader * reader;
+	Chunk chunk;
+	char carry[INSTR_CHARS + 2];	/* start of a line split between chunks */
+	size_t kept = 0;
+	size_t seen = 0;
+	char * data;
+	char * end;
+	char * newline;
+	size_t length;
+	int got;
+
+	if ((reader = openAsyncReader(paths, nPaths, backend, (int)options.threads)) == NULL)
+		return 0;
+
+	while ((got = nextChunk(reader, &chunk)) > 0)
+	{
+		totals->bytes += chunk.length;
+		if (chunk.error != 0)
+			totals->failed++;
+
+		/* Only lines of 32 characters (and perhaps a '\r') can be valid,
+		 * so a split line needs no more than that carried over.
+		 */
+		data = chunk.data;
+		end = data + chunk.length;
+		while ((newline = memchr(data, '\n', (size_t)(end - data))) != NULL)
+		{
+			length = (size_t)(newline - data);
+			if (seen == 0)
+				decodeLine(data, length, totals);
+			else
+			{
+				if (kept + length <= sizeof(carry))
+					memcpy(carry + kept, data, length);
+				decodeLine(carry, seen + length, totals);
+				kept = seen = 0;
+			}
+			data = newline + 1;
+		}
+
+		length = (size_t)(end - data);
+		if (kept + length <= sizeof(carry))
+		{
+			memcpy(carry + kept, data, length);
+			kept += length;
+		}
+		seen += length;
+
+		if (chunk.last)
+		{
+			if (seen > 0)
+				decodeLine(carry, seen, totals);
+			kept = seen = 0;
+			totals->files++;
+		}
+	}
+
+	closeAsyncReader(reader);
+	return got == 0;
+}
+
+/* Counts one line and, if it is a valid instruction, decodes it. */
+static void decodeLine(const char * line, size_t length, Totals * totals)
+{
+	char text[FORMAT_LIMIT];
+	char bits[INSTR_CHARS + 1];
+
+	totals->lines++;
+	if (length == INSTR_CHARS + 1 && line[INSTR_CHARS] == '\r')
+		length--;
+	if (length != INSTR_CHARS)
+		return;
+
+	memcpy(bits, line, INSTR_CHARS);
+	bits[INSTR_CHARS] = '\0';
+	if (strspn(bits, "01") == INSTR_CHARS
+		&& formatInstruction(packMIPSInstruction(bits), text) >= 0)
+	{
+		totals->valid++;
+		totals->check = totals->check * 31 + (unsigned char)text[0] + (unsigned int)strlen(text);
+	}
+}
+
+/* Asks the kernel to drop the files' pages from the page cache. */
+static void dropFromCache(char * const paths[], int nPaths)
+{
+	int fd;
+	int i;
+
+	for (i = 0; i < nPaths; i++)
+	{
+		if ((fd = open(paths[i], O_RDONLY)) >= 0)
+		{
+			posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+			close(fd);
+		}
+	}
+}
+
+static double now(void)
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
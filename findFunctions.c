@@ -0,0 +1,348 @@
+/*
+ * findFunctions
+ *
+ * This file implements the --functions option: find where the functions
+ * of a program with no symbols start and end, and the stack frame each
+ * one sets up, from the instructions alone.
+ *
+ * int findFunctions(LineReader * reader)
+ *   Reads the whole input and prints one line per function found, e.g.
+ *      0x00400120-0x0040019c     32  frame 40  saves $s0 $s1 $ra  called 3
+ *   giving the addresses of its first and last instructions, how many
+ *   instructions it has, the bytes its prologue takes from $sp, the
+ *   registers its prologue saves on the stack, "leaf" if it makes no
+ *   calls, and how many jal instructions call it; then a line of totals.
+ *   Returns: the exit status for main (0 unless the program was empty
+ *            or there was not enough memory).
+ *
+ * A function starts
+ *      at the first instruction,
+ *      at the first instruction after a function ends that is not a nop
+ *          (nops between functions are padding, and belong to none),
+ *      at a prologue, "addiu $sp, $sp, -N", in a function that has
+ *          already set up its frame, and
+ *      at the target of any jal.
+ * A function ends with the delay slot of a "jr $ra", unless a branch in
+ * the function jumps past it (an early return), where the next one
+ * starts, or at a gap in the addresses of an image.  The registers saved
+ * are those stored with "sw reg, k($sp)" after the prologue and before
+ * the first branch or jump, and before any jal target that splits the
+ * function there (a store after one is in a piece with no frame).
+ * Addresses are those the image gives, or for lines, worked out from
+ * --base, as for --callgraph.
+ *
+ * Implementation:
+ *      One linear pass over the words, read in blocks, runs a small state
+ *      machine: whether a function is open, whether its prologue is still
+ *      going (so stores to the stack are saved registers), the furthest
+ *      address its branches reach, and whether the last instruction was
+ *      a return (so this one is its delay slot).  Each function found
+ *      takes one Function record, each jal one CallSite and each saved
+ *      register one Save, so memory grows with the number of functions
+ *      and calls, not with the size of the program.  Afterwards all four
+ *      lists are sorted by address (an image's records need not come in
+ *      address order), and one walk along them splits each function at
+ *      the call targets inside it, counts the calls to each piece, sees
+ *      whether it makes any and gathers the registers it saves.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+
+#include "disassembler.h"
+
+#define FUNCTION_BLOCK	65536		/* words read at a time */
+#define REG_SP			29
+#define JR_RA			0x03E00008U	/* jr $ra */
+#define NO_PROLOGUE		0xFFFFFFFFU
+
+typedef struct
+{
+	uint32_t start;			/* address of the first instruction */
+	uint32_t end;			/* address after the last one */
+	uint32_t prologue;		/* address of its addiu $sp, or NO_PROLOGUE */
+	uint32_t frame;			/* bytes the prologue takes from $sp */
+} Function;
+
+typedef struct
+{
+	uint32_t site;			/* address of the jal */
+	uint32_t target;
+} CallSite;
+
+typedef struct
+{
+	uint32_t address;		/* address of the sw */
+	uint32_t reg;
+} Save;
+
+typedef struct
+{
+	Function * list;
+	size_t count;
+	size_t capacity;
+	Save * saves;			/* registers saved, by every function */
+	size_t nSaves;
+	size_t saveCapacity;
+	Function current;		/* the function being scanned */
+	int open;				/* 1 if current has started */
+	int inPrologue;			/* 1 between its addiu $sp and first branch */
+	int afterReturn;		/* 1 if the last instruction was jr $ra */
+	uint32_t reach;			/* furthest address its branches jump to */
+} Scan;
+
+static int scanWord(Scan * scan, unsigned int word, uint32_t address);
+static void beginFunction(Scan * scan, uint32_t address);
+static int endFunction(Scan * scan, uint32_t address);
+static void printFunction(const Function * function, uint32_t start, uint32_t end,
+						  uint32_t saved, size_t called, int leaf);
+static int compareAddresses(const void * a, const void * b);
+
+int findFunctions(LineReader * reader)
+{
+	static unsigned int words[FUNCTION_BLOCK];
+	static int lineNums[FUNCTION_BLOCK];
+	static unsigned int addresses[FUNCTION_BLOCK];
+	Scan scan;
+	CallSite * calls = NULL, * moreCalls;
+	size_t nCalls = 0, callCapacity = 0;
+	uint32_t * targets = NULL;	/* call targets, sorted */
+	unsigned int next = (unsigned int)options.textBase;	/* address after the last word */
+	uint32_t address, last = 0;
+	uint32_t start, end, saved;
+	size_t f, c, t, v, called;
+	size_t nPieces = 0, nFramed = 0, nLeaf = 0, nCalled = 0;
+	int hasCall;
+	int lineNum = 0;
+	int total = 0;
+	int ok = 1;
+	int n, k;
+
+	memset(&scan, 0, sizeof(scan));
+	while (ok && (n = readAddressBlock(reader, words, addresses, lineNums, FUNCTION_BLOCK,
+									   &lineNum, &next)) > 0)
+	{
+		for (k = 0; ok && k < n; k++, total++)
+		{
+			address = addresses[k];
+			if (scan.open && address != last + 4)
+				ok = endFunction(&scan, last + 4);			/* a gap in the image */
+			ok = ok && scanWord(&scan, words[k], address);
+			if (ok && OPCODE(words[k]) == 3)					/* jal */
+			{
+				if (nCalls == callCapacity)
+				{
+					callCapacity = callCapacity ? 2 * callCapacity : 4096;
+					if ((moreCalls = realloc(calls, callCapacity * sizeof(CallSite))) == NULL)
+					{
+						ok = 0;
+						continue;
+					}
+					calls = moreCalls;
+				}
+				calls[nCalls].site = address;
+				calls[nCalls].target = ((address + 4) & 0xF0000000) | (TARGET(words[k]) << 2);
+				nCalls++;
+			}
+			last = address;
+		}
+	}
+
+	if (ok && total == 0)
+	{
+		printError("Error: The program has no instructions.\n");
+		return 1;
+	}
+	if (ok && scan.open)
+		ok = endFunction(&scan, last + 4);
+	if (!ok || (targets = malloc((nCalls + 1) * sizeof(uint32_t))) == NULL)
+	{
+		printError("Error: Not enough memory for the functions.\n");
+		free(calls);
+		free(scan.list);
+		free(scan.saves);
+		return 1;
+	}
+
+	for (c = 0; c < nCalls; c++)
+		targets[c] = calls[c].target;
+	qsort(targets, nCalls, sizeof(uint32_t), compareAddresses);
+	qsort(calls, nCalls, sizeof(CallSite), compareAddresses);
+	qsort(scan.list, scan.count, sizeof(Function), compareAddresses);
+	qsort(scan.saves, scan.nSaves, sizeof(Save), compareAddresses);
+
+	/* Split each function at the call targets inside it, and count the
+	 * calls to each piece.  Targets outside every function are skipped.
+	 */
+	for (f = 0, c = 0, t = 0, v = 0; f < scan.count; f++)
+	{
+		for (start = scan.list[f].start; start < scan.list[f].end; start = end)
+		{
+			while (t < nCalls && targets[t] < start)
+				t++;
+			for (called = 0; t < nCalls && targets[t] == start; t++)
+				called++;
+			end = t < nCalls && targets[t] < scan.list[f].end ? targets[t] : scan.list[f].end;
+
+			while (c < nCalls && calls[c].site < start)
+				c++;
+			hasCall = c < nCalls && calls[c].site < end;
+
+			while (v < scan.nSaves && scan.saves[v].address < start)
+				v++;
+			for (saved = 0; v < scan.nSaves && scan.saves[v].address < end; v++)
+				saved |= 1U << scan.saves[v].reg;
+
+			printFunction(&scan.list[f], start, end, saved, called, !hasCall);
+			nPieces++;
+			nFramed += scan.list[f].prologue >= start && scan.list[f].prologue < end;
+			nLeaf += !hasCall;
+			nCalled += called > 0;
+		}
+	}
+	printf("%zu functions: %zu with a stack frame, %zu leaf, %zu called with jal\n",
+		   nPieces, nFramed, nLeaf, nCalled);
+
+	free(targets);
+	free(calls);
+	free(scan.list);
+	free(scan.saves);
+	return 0;
+}
+
+/* Runs the state machine on the instruction word at address.  Returns 0
+ * if there is not enough memory to record a function it ends or a
+ * register it saves.
+ */
+static int scanWord(Scan * scan, unsigned int word, uint32_t address)
+{
+	unsigned int opcode = OPCODE(word);
+	uint32_t target;
+	Save * saves;
+
+	if (!scan->open)
+	{
+		if (word == 0)
+			return 1;									/* padding */
+		beginFunction(scan, address);
+	}
+
+	/* addiu $sp, $sp, -N: the prologue, or if this function already has
+	 * one, the start of the next function.
+	 */
+	if (opcode == 9 && RS(word) == REG_SP && RT(word) == REG_SP && (IMM(word) & 0x8000))
+	{
+		if (scan->current.prologue != NO_PROLOGUE)
+		{
+			if (!endFunction(scan, address))
+				return 0;
+			beginFunction(scan, address);
+		}
+		scan->current.prologue = address;
+		scan->current.frame = 0x10000 - IMM(word);
+		scan->inPrologue = 1;
+	}
+	else if (scan->inPrologue && opcode == 43 && RS(word) == REG_SP)	/* sw reg, k($sp) */
+	{
+		if (scan->nSaves == scan->saveCapacity)
+		{
+			if ((saves = realloc(scan->saves, (scan->saveCapacity ? 2 * scan->saveCapacity : 1024)
+								 * sizeof(Save))) == NULL)
+				return 0;
+			scan->saves = saves;
+			scan->saveCapacity = scan->saveCapacity ? 2 * scan->saveCapacity : 1024;
+		}
+		scan->saves[scan->nSaves].address = address;
+		scan->saves[scan->nSaves].reg = RT(word);
+		scan->nSaves++;
+	}
+	else if (opcode == 4 || opcode == 5 || opcode == 6 || opcode == 7 || opcode == 1)
+	{
+		/* beq, bne, blez, bgtz, bltz/bgez: note how far the function reaches */
+		target = address + 4 + ((uint32_t)(int16_t)IMM(word) << 2);
+		if (target > scan->reach)
+			scan->reach = target;
+		scan->inPrologue = 0;
+	}
+	else if (opcode == 2 || opcode == 3 || (opcode == 0 && (FUNCT(word) == 8 || FUNCT(word) == 9)))
+		scan->inPrologue = 0;							/* j, jal, jr, jalr */
+
+	/* The delay slot of jr $ra ends the function, unless a branch in it
+	 * goes further.
+	 */
+	if (scan->afterReturn && scan->reach <= address)
+		return endFunction(scan, address + 4);
+	scan->afterReturn = word == JR_RA;
+	return 1;
+}
+
+static void beginFunction(Scan * scan, uint32_t address)
+{
+	scan->current.start = address;
+	scan->current.prologue = NO_PROLOGUE;
+	scan->current.frame = 0;
+	scan->open = 1;
+	scan->inPrologue = 0;
+	scan->afterReturn = 0;
+	scan->reach = address;
+}
+
+/* Records the current function as ending just before end.  Returns 0 if
+ * there is not enough memory for it.
+ */
+static int endFunction(Scan * scan, uint32_t end)
+{
+	Function * list;
+
+	if (scan->count == scan->capacity)
+	{
+		if ((list = realloc(scan->list, (scan->capacity ? 2 * scan->capacity : 1024)
+							* sizeof(Function))) == NULL)
+			return 0;
+		scan->list = list;
+		scan->capacity = scan->capacity ? 2 * scan->capacity : 1024;
+	}
+	scan->current.end = end;
+	scan->list[scan->count++] = scan->current;
+	scan->open = 0;
+	return 1;
+}
+
+/* Prints the piece of function from start to end, which has the frame,
+ * and the saved registers in it, if it holds the prologue.
+ */
+static void printFunction(const Function * function, uint32_t start, uint32_t end,
+						  uint32_t saved, size_t called, int leaf)
+{
+	int framed = function->prologue >= start && function->prologue < end;
+	int reg;
+
+	printf("0x%08x-0x%08x %6u  frame %-5u", start, end - 4, (end - start) / 4,
+		   framed ? function->frame : 0);
+	if (framed && saved != 0)
+	{
+		printf(" saves");
+		for (reg = 0; reg < 32; reg++)
+		{
+			if (saved & (1U << reg))
+				printf(" %s", getRegName(reg));
+		}
+	}
+	if (leaf)
+		printf("  leaf");
+	if (called > 0)
+		printf("  called %zu", called);
+	printf("\n");
+}
+
+/* Compares two addresses, or two records by the address they start
+ * with (Function, CallSite and Save all do).
+ */
+static int compareAddresses(const void * a, const void * b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
@@ -0,0 +1,373 @@
+/*
+ * formatInstruction
+ *
+ * These functions turn a packed instruction word into its MIPS assembly
+ * text, e.g. 0x02484020 becomes "add $t0, $s2, $t0".  processRaw and the
+ * modes that work on packed words all format through here.
+ *
+ * int formatInstruction(unsigned int word, char text[])
+ *   Pre-condition:  text has room for FORMAT_LIMIT characters
+ *   Post-condition: text holds the instruction, or an error message
+ *                   ("Error: Unknown Function" or "Error: Unknown OP
+ *                   Code") if the word is not in the instruction table
+ *   Returns: the length of text, or -1 if the word is not an instruction
+ *
+ * int formatPseudoInstruction(unsigned int word, char text[])
+ *   Like formatInstruction, but prints the common pseudo-instructions
+ *   by their usual names:
+ *      sll $zero, $zero, 0               nop
+ *      addu/or rd, rs, $zero             move rd, rs
+ *      addiu/ori rt, $zero, imm          li rt, value
+ *      beq $zero, $zero, imm             b imm
+ *      beq/bne rs, $zero, imm            beqz/bnez rs, imm
+ *
+ * int formatPseudoPair(unsigned int first, unsigned int second, char text[])
+ *   Returns: the length of text if first is a lui and second the ori or
+ *            addiu that completes the constant, in which case text holds
+ *            "li rt, value" or "la rt, address"; -1 otherwise.  The pair
+ *            is merged if second writes the lui's register, or reads it
+ *            and the lui's register is the assembler temporary $at.
+ *
+ * int setImmediateStyle(const char * style)
+ *   Chooses how 16-bit immediates and jump targets are printed:
+ *      "dec"     unsigned decimal, e.g. 65535 (the default)
+ *      "signed"  decimal, sign-extended for the instructions that
+ *                sign-extend their immediate, e.g. -1; andi, ori and
+ *                lui stay unsigned
+ *      "hex"     hex with a leading 0x, e.g. 0xffff
+ *   Shift amounts are always decimal.  The 32-bit constants of li and
+ *   la are printed in the same style, signed if the style is "signed".
+ *   Returns: 1, or 0 if style is not one of the above (the caller reports
+ *            it, since the batch library must not print or exit).
+ *
+ * Implementation:
+ *      The mnemonic comes from the instruction table and the operands
+ *      are written in the order given by the instruction's layout.  The
+ *      text is written through a cursor, so each byte is stored once and
+ *      nothing is rescanned (no strcat).  Register names and their
+ *      lengths are in a table, so a register is one small memcpy.
+ *
+ *      Decimal numbers are converted without division by 10 per digit:
+ *      the number of digits is counted with comparisons that compile to
+ *      flag arithmetic rather than branches, then the digits are written
+ *      from the right two at a time from the "00" to "99" pair table.
+ *      Hex digits are one table load each.
+ *
+ *      setImmediateStyle picks the function that writes immediates once,
+ *      so the choice costs nothing per instruction beyond the call that
+ *      the default style makes anyway.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <string.h>
+
+#include "printFuncs.h"
+#include "mipsInstructions.h"
+
+#define REG(name)	{ name, sizeof(name) - 1 }
+
+static const struct
+{
+	char name[6];
+	int  length;
+} registers[32] = {
+	REG("$zero"),
+	REG("$at"),
+	REG("$v0"), REG("$v1"),
+	REG("$a0"), REG("$a1"), REG("$a2"), REG("$a3"),
+	REG("$t0"), REG("$t1"), REG("$t2"), REG("$t3"),
+	REG("$t4"), REG("$t5"), REG("$t6"), REG("$t7"),
+	REG("$s0"), REG("$s1"), REG("$s2"), REG("$s3"),
+	REG("$s4"), REG("$s5"), REG("$s6"), REG("$s7"),
+	REG("$t8"), REG("$t9"),
+	REG("$k0"), REG("$k1"),
+	REG("$gp"), REG("$sp"), REG("$fp"), REG("$ra")
+};
+
+static const char digitPairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const char hexDigits[] = "0123456789abcdef";
+
+static char * emitDecimal(char * cursor, unsigned int value);
+static char * emitUnsigned(char * cursor, unsigned int value, int signExtended);
+static char * emitSigned(char * cursor, unsigned int value, int signExtended);
+static char * emitHex(char * cursor, unsigned int value, int signExtended);
+static char * emitConstant(char * cursor, unsigned int value);
+static char * emitMnemonic(char * cursor, const char * name);
+
+/* Writes an immediate (or jump target); chosen by setImmediateStyle. */
+static char * (*emitImmediate)(char * cursor, unsigned int value, int signExtended) = emitUnsigned;
+
+static inline char * emitRegister(char * cursor, unsigned int reg)
+{
+	memcpy(cursor, registers[reg].name, registers[reg].length);
+	return cursor + registers[reg].length;
+}
+
+static inline char * emitSeparator(char * cursor)
+{
+	cursor[0] = ',';
+	cursor[1] = ' ';
+	return cursor + 2;
+}
+
+int formatInstruction(unsigned int word, char text[])
+{
+	const InstrInfo * instr = findInstruction(word);
+	char * cursor = text;
+	int signExtended;
+
+	if (instr == NULL)
+	{
+		strcpy(text, OPCODE(word) == 0 ? "Error: Unknown Function"
+									   : "Error: Unknown OP Code");
+		return -1;
+	}
+
+	cursor = emitMnemonic(cursor, instr->name);
+
+	/* andi, ori and lui zero-extend their immediates. */
+	signExtended = instr->opcode != 12 && instr->opcode != 13 && instr->opcode != 15;
+
+	switch (instr->layout)
+	{
+		case LAYOUT_R3 :
+			cursor = emitSeparator(emitRegister(cursor, RD(word)));
+			cursor = emitSeparator(emitRegister(cursor, RS(word)));
+			cursor = emitRegister(cursor, RT(word));
+		break;
+
+		case LAYOUT_SHIFT :
+			cursor = emitSeparator(emitRegister(cursor, RD(word)));
+			cursor = emitSeparator(emitRegister(cursor, RT(word)));
+			cursor = emitDecimal(cursor, SHAMT(word));
+		break;
+
+		case LAYOUT_JR :
+			cursor = emitRegister(cursor, RS(word));
+		break;
+
+		case LAYOUT_ARITH :
+			cursor = emitSeparator(emitRegister(cursor, RT(word)));
+			cursor = emitSeparator(emitRegister(cursor, RS(word)));
+			cursor = emitImmediate(cursor, IMM(word), signExtended);
+		break;
+
+		case LAYOUT_BRANCH :
+			cursor = emitSeparator(emitRegister(cursor, RS(word)));
+			cursor = emitSeparator(emitRegister(cursor, RT(word)));
+			cursor = emitImmediate(cursor, IMM(word), signExtended);
+		break;
+
+		case LAYOUT_LUI :
+			cursor = emitSeparator(emitRegister(cursor, RT(word)));
+			cursor = emitImmediate(cursor, IMM(word), signExtended);
+		break;
+
+		case LAYOUT_MEM :
+			cursor = emitSeparator(emitRegister(cursor, RT(word)));
+			cursor = emitImmediate(cursor, IMM(word), signExtended);
+			*cursor++ = '(';
+			cursor = emitRegister(cursor, RS(word));
+			*cursor++ = ')';
+		break;
+
+		default : /* LAYOUT_JUMP: the target is printed as a byte address */
+			cursor = emitImmediate(cursor, TARGET(word) * 4, 0);
+		break;
+	}
+
+	*cursor = '\0';
+	return (int)(cursor - text);
+}
+
+int formatPseudoInstruction(unsigned int word, char text[])
+{
+	char * cursor = text;
+	unsigned int funct = FUNCT(word);
+
+	if (word == 0)
+	{
+		strcpy(text, "nop");
+		return 3;
+	}
+
+	switch (OPCODE(word))
+	{
+		case 0 : /* addu or or with $zero as one operand */
+			if ((funct != 33 && funct != 37) || SHAMT(word) != 0
+				|| (RS(word) != 0 && RT(word) != 0))
+				return formatInstruction(word, text);
+			cursor = emitMnemonic(cursor, "move");
+			cursor = emitSeparator(emitRegister(cursor, RD(word)));
+			cursor = emitRegister(cursor, RS(word) | RT(word));
+		break;
+
+		case 9 :  /* addiu rt, $zero, imm */
+		case 13 : /* ori rt, $zero, imm */
+			if (RS(word) != 0)
+				return formatInstruction(word, text);
+			cursor = emitMnemonic(cursor, "li");
+			cursor = emitSeparator(emitRegister(cursor, RT(word)));
+			cursor = emitConstant(cursor, OPCODE(word) == 9
+								  ? (unsigned int)(int)(short)IMM(word) : IMM(word));
+		break;
+
+		case 4 : /* beq */
+		case 5 : /* bne */
+			if (RT(word) != 0)
+				return formatInstruction(word, text);
+			if (OPCODE(word) == 4 && RS(word) == 0)
+			{
+				cursor = emitMnemonic(cursor, "b");
+			}
+			else
+			{
+				cursor = emitMnemonic(cursor, OPCODE(word) == 4 ? "beqz" : "bnez");
+				cursor = emitSeparator(emitRegister(cursor, RS(word)));
+			}
+			cursor = emitImmediate(cursor, IMM(word), 1);
+		break;
+
+		default :
+			return formatInstruction(word, text);
+	}
+
+	*cursor = '\0';
+	return (int)(cursor - text);
+}
+
+int formatPseudoPair(unsigned int first, unsigned int second, char text[])
+{
+	char * cursor = text;
+	unsigned int reg = RT(first);
+	unsigned int value;
+
+	if (OPCODE(first) != 15 || (OPCODE(second) != 9 && OPCODE(second) != 13)
+		|| RS(second) != reg || (RT(second) != reg && reg != 1))
+		return -1;
+
+	if (OPCODE(second) == 13)
+	{
+		value = (IMM(first) << 16) | IMM(second);
+		cursor = emitMnemonic(cursor, "li");
+	}
+	else
+	{
+		value = (IMM(first) << 16) + (unsigned int)(int)(short)IMM(second);
+		cursor = emitMnemonic(cursor, "la");
+	}
+
+	cursor = emitSeparator(emitRegister(cursor, RT(second)));
+	cursor = emitConstant(cursor, value);
+
+	*cursor = '\0';
+	return (int)(cursor - text);
+}
+
+int setImmediateStyle(const char * style)
+{
+	if (style == NULL || strcmp(style, "dec") == 0)
+		emitImmediate = emitUnsigned;
+	else if (strcmp(style, "signed") == 0)
+		emitImmediate = emitSigned;
+	else if (strcmp(style, "hex") == 0)
+		emitImmediate = emitHex;
+	else
+		return 0;
+
+	return 1;
+}
+
+static char * emitDecimal(char * cursor, unsigned int value)
+{
+	int length = 1 + (value >= 10) + (value >= 100) + (value >= 1000)
+		+ (value >= 10000) + (value >= 100000) + (value >= 1000000)
+		+ (value >= 10000000) + (value >= 100000000) + (value >= 1000000000);
+	char * digit = cursor + length;
+	unsigned int pair;
+
+	while (value >= 100)
+	{
+		pair = value % 100;
+		value /= 100;
+		digit -= 2;
+		memcpy(digit, digitPairs + 2 * pair, 2);
+	}
+
+	if (value >= 10)
+	{
+		memcpy(digit - 2, digitPairs + 2 * value, 2);
+	}
+	else
+	{
+		digit[-1] = (char)('0' + value);
+	}
+
+	return cursor + length;
+}
+
+static char * emitUnsigned(char * cursor, unsigned int value, int signExtended)
+{
+	(void)signExtended;
+	return emitDecimal(cursor, value);
+}
+
+static char * emitSigned(char * cursor, unsigned int value, int signExtended)
+{
+	if (signExtended && (value & 0x8000))
+	{
+		*cursor++ = '-';
+		value = 0x10000 - value;
+	}
+
+	return emitDecimal(cursor, value);
+}
+
+static char * emitHex(char * cursor, unsigned int value, int signExtended)
+{
+	int length = 1 + (value >= 0x10) + (value >= 0x100) + (value >= 0x1000)
+		+ (value >= 0x10000) + (value >= 0x100000) + (value >= 0x1000000)
+		+ (value >= 0x10000000);
+	char * digit;
+
+	(void)signExtended;
+	cursor[0] = '0';
+	cursor[1] = 'x';
+	cursor += 2;
+
+	for (digit = cursor + length - 1; digit >= cursor; digit--)
+	{
+		*digit = hexDigits[value & 0xF];
+		value >>= 4;
+	}
+
+	return cursor + length;
+}
+
+/* Writes the 32-bit constant of li or la in the chosen style. */
+static char * emitConstant(char * cursor, unsigned int value)
+{
+	if (emitImmediate == emitSigned && (value & 0x80000000))
+	{
+		*cursor++ = '-';
+		return emitDecimal(cursor, 0 - value);
+	}
+
+	return emitImmediate(cursor, value, 0);
+}
+
+/* Writes the mnemonic and the space after it. */
+static char * emitMnemonic(char * cursor, const char * name)
+{
+	while (*name != '\0')
+	{
+		*cursor++ = *name++;
+	}
+	*cursor++ = ' ';
+	return cursor;
+}
@@ -26,12 +26,32 @@
  *    If rNbr1 = 8, rNbr2 = 9, rNbr3 = 16, this will print:
  *		add $t0, $t1, $s0
  *
+ * getRegNbr does the reverse lookup:
+ *
+ *      int getRegNbr(const char * name)
+ *          Parameter: name is a register name such as "$t0", or a
+ *              register number written as "$8"
+ *          Returns: the register number (0 - 31), or -1 if name is not
+ *              a register
+ *
+ *    Register names are found with a perfect hash of the names in
+ *    regArray (see perfectHash in instructionTable.c), so a lookup is
+ *    one hash and one strcmp.  The slots are a constant table, checked
+ *    against regArray by checkTables when the program is built.
+ *
  * Author: Alyce Brady and Garrett Olson
  * Date:   2/10/99
  *		modified: Tim Rutledge, 4/17/2018        Completed register list and return.
+ *		modified: 10/19/2026        Added getRegNbr for the --match option.
+ *		modified: 10/19/2026        getRegNbr uses a perfect hash for the assembler.
+ *		modified: 10/19/2026        The hash slots are a constant table.
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "printFuncs.h"
+#include "mipsInstructions.h"
 
  /* Create a static (persistent) array of the mnemonic names,
  *    each of which is a string (char *).
@@ -58,3 +78,33 @@ char * getRegName (int regNbr)
 
 	return regArray[regNbr];
 }
+
+static const unsigned int REGISTER_HASH[4] = { 1, 7, 5, 7 };
+
+/* Register number by name hash, -1 if none. */
+static const signed char regSlots[HASH_SIZE] = {
+	-1, -1, -1, -1, 16,  4, 29, -1, -1, 17,  5,  8, 26, -1, 18,  6,
+	 9, 27, -1, 19,  7, 10, -1, -1, 20,  2, 11, -1,  1, 21,  3, 12,
+	-1, -1, 22, -1, 13, -1, -1, 23, -1, 14, -1, 30, -1, -1, 15, -1,
+	-1, -1, 28, 24, 31,  0, -1, -1, 25, -1, -1, -1, -1, -1, -1, -1
+};
+
+int getRegNbr (const char * name)
+{
+	int i;
+	char * end;
+	long nbr;
+
+	if (name[0] != '$')
+		return -1;
+
+	if (name[1] >= '0' && name[1] <= '9') /* numbered form, e.g. "$8" */
+	{
+		nbr = strtol(name + 1, &end, 10);
+		return (*end == '\0' && nbr >= 0 && nbr <= 31) ? (int)nbr : -1;
+	}
+
+	i = regSlots[perfectHash(name, strlen(name), REGISTER_HASH)];
+
+	return (i >= 0 && strcmp(regArray[i], name) == 0) ? i : -1;
+}
@@ -0,0 +1,142 @@
+/*
+ * instructionTable
+ *
+ * This file holds the table of MIPS instructions supported by the
+ * disassembler (the same ones processR, processI and processJ handle)
+ * and the functions used to look instructions up in it.
+ *
+ *   const InstrInfo * findInstruction(unsigned int word)
+ *      Returns: the table entry for the packed instruction word, or
+ *               NULL if the opcode (and funct, for R format) is not in
+ *               the table.
+ *
+ *   const InstrInfo * findInstructionByName(const char * name)
+ *      Returns: the table entry with the given mnemonic, or NULL.
+ *
+ *   unsigned int perfectHash(const char * s, size_t length,
+ *                            const unsigned int k[4])
+ *      Returns: a hash of s between 0 and HASH_SIZE - 1, computed from
+ *               its first two characters, its last one and its length.
+ *
+ * Implementation:
+ *      findInstruction uses two 64 entry index arrays, one per opcode
+ *      and one per R format function value, so a lookup is a couple of
+ *      array reads.
+ *
+ *      findInstructionByName uses perfectHash with the constants in
+ *      MNEMONIC_HASH, which were chosen (by trying small values until
+ *      none of the mnemonics collide) so that every mnemonic in the
+ *      table has its own slot.  A lookup is one hash and one strcmp.
+ *      getRegNbr (getRegName.c) does the same for register names.
+ *
+ *      The index arrays and the slots are constant tables written out
+ *      from instructionTable, so nothing is built at run time and any
+ *      number of threads can look instructions up at once.  "make" runs
+ *      checkTables (checkTables.c), which looks up every word, mnemonic
+ *      and register and stops the build if a lookup gives the wrong
+ *      entry: if an instruction is added, its slots need adding here,
+ *      and if its mnemonic collides, the constants need choosing again.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "printFuncs.h"
+#include "mipsInstructions.h"
+
+const InstrInfo instructionTable[] = {
+	{ "sll",   'R',  0,  0, LAYOUT_SHIFT  },
+	{ "srl",   'R',  0,  2, LAYOUT_SHIFT  },
+	{ "jr",    'R',  0,  8, LAYOUT_JR     },
+	{ "add",   'R',  0, 32, LAYOUT_R3     },
+	{ "addu",  'R',  0, 33, LAYOUT_R3     },
+	{ "sub",   'R',  0, 34, LAYOUT_R3     },
+	{ "subu",  'R',  0, 35, LAYOUT_R3     },
+	{ "and",   'R',  0, 36, LAYOUT_R3     },
+	{ "or",    'R',  0, 37, LAYOUT_R3     },
+	{ "nor",   'R',  0, 39, LAYOUT_R3     },
+	{ "slt",   'R',  0, 42, LAYOUT_R3     },
+	{ "sltu",  'R',  0, 43, LAYOUT_R3     },
+	{ "beq",   'I',  4, -1, LAYOUT_BRANCH },
+	{ "bne",   'I',  5, -1, LAYOUT_BRANCH },
+	{ "addi",  'I',  8, -1, LAYOUT_ARITH  },
+	{ "addiu", 'I',  9, -1, LAYOUT_ARITH  },
+	{ "slti",  'I', 10, -1, LAYOUT_ARITH  },
+	{ "sltiu", 'I', 11, -1, LAYOUT_ARITH  },
+	{ "andi",  'I', 12, -1, LAYOUT_ARITH  },
+	{ "ori",   'I', 13, -1, LAYOUT_ARITH  },
+	{ "lui",   'I', 15, -1, LAYOUT_LUI    },
+	{ "lw",    'I', 35, -1, LAYOUT_MEM    },
+	{ "sw",    'I', 43, -1, LAYOUT_MEM    },
+	{ "j",     'J',  2, -1, LAYOUT_JUMP   },
+	{ "jal",   'J',  3, -1, LAYOUT_JUMP   }
+};
+
+const int INSTRUCTION_COUNT = sizeof(instructionTable) / sizeof(instructionTable[0]);
+
+/* Table index by opcode, -1 if none. */
+static const signed char opcodeIndex[64] = {
+	-1, -1, 23, 24, 12, 13, -1, -1, 14, 15, 16, 17, 18, 19, -1, 20,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, 21, -1, -1, -1, -1, -1, -1, -1, 22, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* Table index by funct (opcode 0), -1 if none. */
+static const signed char functIndex[64] = {
+	 0, -1,  1, -1, -1, -1, -1, -1,  2, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	 3,  4,  5,  6,  7,  8, -1,  9, -1, -1, 10, 11, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+static const unsigned int MNEMONIC_HASH[4] = { 1, 3, 3, 3 };
+
+/* Table index by mnemonic hash, -1 if none. */
+static const signed char nameSlots[HASH_SIZE] = {
+	 8, -1, -1, 12, -1, -1, -1, 18, -1, -1, -1, -1, -1, -1,  4, 15,
+	-1, -1, -1,  3, 16, -1, -1, -1, -1, -1,  5,  6, -1,  0, 23, 21,
+	-1, -1, -1, 19, -1, 14, 22, -1, -1, -1, 20, -1, -1, -1, 24, -1,
+	-1, -1,  1, -1, -1,  7,  9, -1, 10, 13, -1,  2, -1, 11, 17, -1
+};
+
+unsigned int perfectHash(const char * s, size_t length, const unsigned int k[4])
+{
+	unsigned int x;
+
+	if (length == 0)
+		return 0;
+
+	x = (unsigned char)s[0] * k[0]
+		+ (length > 1 ? (unsigned char)s[1] : 0) * k[1]
+		+ (unsigned char)s[length - 1] * k[2]
+		+ (unsigned int)length;
+
+	return (x + (x >> k[3])) & (HASH_SIZE - 1);
+}
+
+const InstrInfo * findInstruction(unsigned int word)
+{
+	int index;
+
+	if (OPCODE(word) == 0)
+		index = functIndex[FUNCT(word)];
+	else
+		index = opcodeIndex[OPCODE(word)];
+
+	return index < 0 ? NULL : &instructionTable[index];
+}
+
+const InstrInfo * findInstructionByName(const char * name)
+{
+	int index;
+
+	index = nameSlots[perfectHash(name, strlen(name), MNEMONIC_HASH)];
+
+	if (index < 0 || strcmp(instructionTable[index].name, name) != 0)
+		return NULL;
+
+	return &instructionTable[index];
+}
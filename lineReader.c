@@ -0,0 +1,316 @@
+/*
+ * lineReader
+ *
+ * These functions read the input one line at a time, like fgets, but
+ * take the data from the file in large blocks with read(2).
+ *
+ * LineReader * openLineReader(FILE * fptr)
+ *   Pre-condition:  nothing has been read from fptr yet
+ *   Returns: a reader for fptr, or NULL (after printing an error
+ *            message, and closing fptr) if there is not enough memory
+ *            or compressed input cannot be set up.
+ *   If the input starts with the gzip or zstd magic bytes, it is read
+ *   through decompressInput, which decompresses it on another thread.
+ *
+ * char * readLine(LineReader * reader, int * length)
+ *   Returns: the next line, without its newline or carriage return and
+ *            followed by a null byte, or NULL at end of file.  *length
+ *            is set to the length of the returned line.  The line stays
+ *            valid until the next call.
+ *   A line longer than LINE_LIMIT characters is returned once, cut to
+ *   LINE_LIMIT characters, so it counts as one (bad) line and the line
+ *   numbers after it stay right.  A final line with no newline is
+ *   returned like any other; an empty line is returned with length 0.
+ *   If the input was compressed and could not all be decompressed, the
+ *   program exits with status 1 at the end of what could be, after the
+ *   decompression thread has printed why, so a corrupt or truncated file
+ *   is not taken for a short one.
+ *
+ * size_t peekInput(LineReader * reader, const unsigned char ** data,
+ *                  size_t want)
+ *   Post-condition: *data points to the next unread bytes, which have
+ *                   not been consumed
+ *   Returns: how many bytes *data holds: want (at most READ_SIZE), or
+ *            fewer at end of file.  Used to work out the input format.
+ *   Only a regular file is read until want bytes are in.  From a
+ *   terminal or a pipe, what has already arrived is returned (after one
+ *   read if nothing has), so a line typed at the terminal is not held
+ *   back waiting for more.
+ *
+ * size_t readBytes(LineReader * reader, void * data, size_t size)
+ *   Reads the next size bytes into data, for input that is not lines.
+ *   Returns: the number read, less than size only at end of file.
+ *
+ * void setWordSource(LineReader * reader, struct WordReader * words)
+ * struct WordReader * wordSource(LineReader * reader)
+ *   Record and return the word reader (see wordReader.c) that reads this
+ *   input as an image, or NULL if it is read as lines.  readWordBlock
+ *   takes its words from there when it is set.
+ *
+ * void closeLineReader(LineReader * reader)
+ *   Frees the reader and closes its file.
+ *
+ * Implementation:
+ *      The reader keeps a buffer of READ_SIZE bytes, plus room for one
+ *      partial line carried over from the previous block.  Newlines are
+ *      found with memchr, which the C library implements with vector
+ *      instructions, so there is no per-character loop here.  When no
+ *      newline is left, the partial line is moved to the front and the
+ *      buffer is refilled.  The rest of an over-long line is skipped by
+ *      refilling and searching for the next newline, without copying.
+ *      Pipes and files are both read with read(2), so a pipe is read in
+ *      the same large blocks as a file.  readBytes hands out what is
+ *      left in the buffer and then reads straight into the caller's
+ *      memory, so raw images are not copied twice.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "printFuncs.h"
+#include "process_arguments.h"
+#include "lineReader.h"
+
+#define READ_SIZE (1 << 20)		/* bytes requested per read(2) */
+
+struct LineReader
+{
+	FILE * fptr;
+	int    fd;
+	char * buffer;				/* LINE_LIMIT + READ_SIZE + 1 bytes */
+	size_t start;				/* first unread byte */
+	size_t end;					/* end of the data in buffer */
+	int    eof;
+	struct WordReader * words;	/* NULL unless read as an image */
+	char   longLine[LINE_LIMIT + 1];
+};
+
+static int fill(LineReader * reader);
+static void endOfInput(LineReader * reader);
+
+LineReader * openLineReader(FILE * fptr)
+{
+	LineReader * reader = malloc(sizeof(LineReader));
+	int fd;
+
+	if (reader == NULL || (reader->buffer = malloc(LINE_LIMIT + READ_SIZE + 1)) == NULL)
+	{
+		printError("Error: Not enough memory for the input buffer.\n");
+		free(reader);
+		fclose(fptr);
+		return NULL;
+	}
+	reader->fptr = fptr;
+	reader->fd = fileno(fptr);
+	reader->start = 0;
+	reader->end = 0;
+	reader->eof = 0;
+	reader->words = NULL;
+
+	/* Read enough to see the magic number of a compressed file. */
+	while (!reader->eof && reader->end < 4)
+		fill(reader);
+
+	if (isCompressed((unsigned char *)reader->buffer, reader->end))
+	{
+		fd = decompressInput(reader->fd, (unsigned char *)reader->buffer, reader->end);
+		if (fd < 0)
+		{
+			closeLineReader(reader);
+			return NULL;
+		}
+		reader->fd = fd;
+		reader->end = 0;
+		reader->eof = 0;
+	}
+
+	return reader;
+}
+
+char * readLine(LineReader * reader, int * length)
+{
+	char * line;
+	char * newline;
+	size_t size;
+
+	for (;;)
+	{
+		line = reader->buffer + reader->start;
+		size = reader->end - reader->start;
+		newline = memchr(line, '\n', size);
+
+		if (newline != NULL || (reader->eof && size > 0))
+		{
+			size = newline ? (size_t)(newline - line) : size;
+			reader->start += size + (newline != NULL);
+			break;
+		}
+
+		if (reader->eof)
+			return NULL;
+
+		if (size > LINE_LIMIT)
+		{
+			/* Over-long line: keep its beginning, skip to its end. */
+			memcpy(reader->longLine, line, LINE_LIMIT);
+			reader->start = reader->end;
+			while (fill(reader) && (newline = memchr(reader->buffer + reader->start, '\n',
+										reader->end - reader->start)) == NULL)
+				reader->start = reader->end;
+			if (newline != NULL)
+				reader->start = newline - reader->buffer + 1;
+			else
+				reader->start = reader->end;
+
+			reader->longLine[LINE_LIMIT] = '\0';
+			*length = LINE_LIMIT;
+			return reader->longLine;
+		}
+
+		/* Move the partial line to the front and read another block. */
+		memmove(reader->buffer, line, size);
+		reader->start = 0;
+		reader->end = size;
+		fill(reader);
+	}
+
+	if (size > 0 && line[size - 1] == '\r')
+		size--;
+	if (size > LINE_LIMIT)
+		size = LINE_LIMIT;
+
+	line[size] = '\0';
+	*length = (int)size;
+	return line;
+}
+
+size_t peekInput(LineReader * reader, const unsigned char ** data, size_t want)
+{
+	struct stat status;
+	size_t need;				/* bytes to wait for */
+	ssize_t got;
+
+	if (want > READ_SIZE)
+		want = READ_SIZE;
+	need = want;
+	if (fstat(reader->fd, &status) != 0 || !S_ISREG(status.st_mode))
+		need = 1;				/* one read at most, of whatever is there */
+
+	/* Not fill, which expects at most a partial line to be unread. */
+	while (!reader->eof && reader->end - reader->start < need)
+	{
+		memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+		reader->end -= reader->start;
+		reader->start = 0;
+
+		got = read(reader->fd, reader->buffer + reader->end, LINE_LIMIT + READ_SIZE - reader->end);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got <= 0)
+		{
+			if (got < 0)
+				printError("Error: Cannot read the input.\n");
+			endOfInput(reader);
+			break;
+		}
+		reader->end += (size_t)got;
+	}
+
+	*data = (const unsigned char *)reader->buffer + reader->start;
+	return reader->end - reader->start < want ? reader->end - reader->start : want;
+}
+
+size_t readBytes(LineReader * reader, void * data, size_t size)
+{
+	size_t have = reader->end - reader->start;
+	size_t done;
+	ssize_t got;
+
+	if (have > size)
+		have = size;
+	memcpy(data, reader->buffer + reader->start, have);
+	reader->start += have;
+
+	for (done = have; done < size && !reader->eof; )
+	{
+		got = read(reader->fd, (char *)data + done, size - done);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got <= 0)
+		{
+			if (got < 0)
+				printError("Error: Cannot read the input.\n");
+			endOfInput(reader);
+			break;
+		}
+		done += (size_t)got;
+	}
+
+	return done;
+}
+
+void setWordSource(LineReader * reader, struct WordReader * words)
+{
+	reader->words = words;
+}
+
+struct WordReader * wordSource(LineReader * reader)
+{
+	return reader->words;
+}
+
+void closeLineReader(LineReader * reader)
+{
+	if (reader->fd != fileno(reader->fptr))
+		close(reader->fd);			/* pipe from decompressInput */
+	fclose(reader->fptr);
+	free(reader->buffer);
+	free(reader);
+}
+
+/* Reads one block after the data already in the buffer (first moving
+ * the unread data to the front if the block would not fit).  Returns 0
+ * at end of file.
+ */
+static int fill(LineReader * reader)
+{
+	ssize_t got;
+
+	if (reader->end + READ_SIZE > LINE_LIMIT + READ_SIZE)
+	{
+		memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+		reader->end -= reader->start;
+		reader->start = 0;
+	}
+
+	do
+	{
+		got = read(reader->fd, reader->buffer + reader->end, READ_SIZE);
+	} while (got < 0 && errno == EINTR);
+
+	if (got <= 0)
+	{
+		if (got < 0)
+			printError("Error: Cannot read the input.\n");
+		endOfInput(reader);
+		return 0;
+	}
+
+	reader->end += (size_t)got;
+	return 1;
+}
+
+/* Marks the end of the input, and exits if it came from decompressInput
+ * and decompression failed.
+ */
+static void endOfInput(LineReader * reader)
+{
+	reader->eof = 1;
+	if (reader->fd != fileno(reader->fptr) && decompressFailed())
+		exit(1);
+}
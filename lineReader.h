@@ -0,0 +1,24 @@
+/*
+ * This file provides the signatures for the line reader, which reads
+ * input lines in large blocks (see lineReader.c).
+ */
+
+#ifndef _LINE_READER_H
+#define _LINE_READER_H
+
+#include <stdio.h>
+
+#define LINE_LIMIT 4096		/* longer lines are cut to this many chars */
+
+typedef struct LineReader LineReader;
+struct WordReader;
+
+LineReader * openLineReader(FILE * fptr);
+char * readLine(LineReader * reader, int * length);
+size_t peekInput(LineReader * reader, const unsigned char ** data, size_t want);
+size_t readBytes(LineReader * reader, void * data, size_t size);
+void setWordSource(LineReader * reader, struct WordReader * words);
+struct WordReader * wordSource(LineReader * reader);
+void closeLineReader(LineReader * reader);
+
+#endif
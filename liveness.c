@@ -0,0 +1,436 @@
+/*
+ * liveness
+ *
+ * This file implements the --liveness option: for every instruction,
+ * which registers it defines (writes) and uses (reads), where each use
+ * was defined, and which registers are live after it, i.e. hold a value
+ * that some later instruction may still read.
+ *
+ * int analyzeLiveness(LineReader * reader, const char * report)
+ *   Reads the whole program and prints the report:
+ *      "lines"    one line per instruction, e.g.
+ *                 Line 12: addu $v0, $a0, $t1   def $v0  use $a0@in $t1@10  live $v0 $sp $ra
+ *                 where $t1@10 means the $t1 read here was written on line
+ *                 10 and $a0@in that it was written before the basic
+ *                 block started
+ *      "summary"  the size of the control flow graph, the registers
+ *                 live on entry to the program (read before they are
+ *                 written) and the callee-saved registers ($s0 - $s7
+ *                 and $fp) that the program clobbers, with the first
+ *                 line that writes each one, then those it saves and
+ *                 restores
+ *   Returns: the exit status for main (0 unless the program was empty
+ *            or report was unknown).
+ *
+ * Registers are used and defined as the instruction layouts say (see
+ * mipsInstructions.h); $zero is never counted.  jal is treated as a
+ * call following the usual convention: it reads $a0 - $a3 and $sp and
+ * writes $ra and every register a callee need not preserve.  At a
+ * "jr $ra" the return values and the callee-saved registers are live;
+ * wherever else control leaves the program, every register is.  In the
+ * summary, a callee-saved register is saved and restored, not clobbered,
+ * if it is stored with "sw reg, k($sp)" before it is written and loaded
+ * again with "lw reg, k($sp)" before the next "jr $ra" (or its delay
+ * slot).
+ *
+ * Implementation:
+ *      Register sets are 32-bit masks, one bit per register.  Each
+ *      basic block (see findBasicBlocks in program.c) is summarized by
+ *      the registers it reads before writing them (use) and the ones it
+ *      writes (def).  Then the usual backward equations
+ *          out(b) = union of in(s) over the successors s of b
+ *          in(b)  = use(b) | (out(b) & ~def(b))
+ *      are solved with a worklist: a block is revisited only when the
+ *      in set of one of its successors changed.  Each in set can only
+ *      grow, one register at a time, so the work is linear in the size
+ *      of the program.  The def-use chains are kept within blocks (the
+ *      last definition of each register is tracked as a block is walked
+ *      forward), which is also linear.  The per-block sets and lists
+ *      are taken from the program's arena, so --max-memory covers them.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+
+#define BIT(r)			(1U << (r))
+#define ALL_REGISTERS	0xFFFFFFFEU			/* everything but $zero */
+#define ARGUMENTS		0x000000F0U			/* $a0 - $a3 */
+#define CALLEE_SAVED	0x40FF0000U			/* $s0 - $s7, $fp */
+#define CALLER_SAVED	0x0300FFFEU			/* $at, $v0 - $v1, $a0 - $a3, $t0 - $t9 */
+#define RETURN_LIVE		(CALLEE_SAVED | 0x0000000CU | BIT(28) | BIT(29) | BIT(31))
+#define REG_SP			29
+#define JR_RA			0x03E00008U			/* jr $ra */
+
+static int printLines(Program * program, const BasicBlock * blocks, int nBlocks,
+					  const unsigned int liveIn[]);
+static void printSummary(const Program * program, const BasicBlock * blocks, int nBlocks,
+						 const unsigned int liveIn[], long visits);
+static unsigned int exitLive(const Program * program, const BasicBlock * block);
+static char * registerList(char * text, unsigned int set);
+
+void instructionDefUse(unsigned int word, unsigned int * def, unsigned int * use)
+{
+	const InstrInfo * instr = findInstruction(word);
+	unsigned int d = 0;
+	unsigned int u = 0;
+
+	if (instr != NULL)
+	{
+		switch (instr->layout)
+		{
+			case LAYOUT_R3 :
+				d = BIT(RD(word));
+				u = BIT(RS(word)) | BIT(RT(word));
+			break;
+
+			case LAYOUT_SHIFT :
+				d = BIT(RD(word));
+				u = BIT(RT(word));
+			break;
+
+			case LAYOUT_JR :
+				u = BIT(RS(word));
+			break;
+
+			case LAYOUT_ARITH :
+				d = BIT(RT(word));
+				u = BIT(RS(word));
+			break;
+
+			case LAYOUT_BRANCH :
+				u = BIT(RS(word)) | BIT(RT(word));
+			break;
+
+			case LAYOUT_LUI :
+				d = BIT(RT(word));
+			break;
+
+			case LAYOUT_MEM :
+				if (instr->opcode == 35)			/* lw */
+				{
+					d = BIT(RT(word));
+					u = BIT(RS(word));
+				}
+				else								/* sw */
+				{
+					u = BIT(RS(word)) | BIT(RT(word));
+				}
+			break;
+
+			default : /* LAYOUT_JUMP */
+				if (instr->opcode == 3)				/* jal: a call */
+				{
+					d = CALLER_SAVED | BIT(31);
+					u = ARGUMENTS | BIT(29);
+				}
+			break;
+		}
+	}
+
+	*def = d & ALL_REGISTERS;
+	*use = u & ALL_REGISTERS;
+}
+
+int analyzeLiveness(LineReader * reader, const char * report)
+{
+	Program program;
+	BasicBlock * blocks;
+	unsigned int * blockUse;
+	unsigned int * blockDef;
+	unsigned int * liveIn;
+	int * predStart;
+	int * preds;
+	int * worklist;
+	unsigned char * queued;
+	unsigned int def, use, out, in;
+	long visits = 0;
+	int status = 0;
+	int nBlocks, top, b, s, i, k;
+
+	if (strcmp(report, "lines") != 0 && strcmp(report, "summary") != 0)
+	{
+		printError("Error: Unknown liveness report %s (use lines or summary).\n", report);
+		closeLineReader(reader);
+		return 1;
+	}
+
+	if (!loadProgram(reader, &program))
+	{
+		closeLineReader(reader);
+		return 1;
+	}
+	closeLineReader(reader);
+
+	nBlocks = findBasicBlocks(&program, &blocks);
+	if (nBlocks == 0)
+	{
+		freeProgram(&program);		/* out of memory, already reported */
+		return 1;
+	}
+	blockUse = arenaAlloc(&program.arena, nBlocks * sizeof(unsigned int));
+	blockDef = arenaAlloc(&program.arena, nBlocks * sizeof(unsigned int));
+	liveIn = arenaAlloc(&program.arena, nBlocks * sizeof(unsigned int));
+	predStart = arenaAlloc(&program.arena, (nBlocks + 1) * sizeof(int));
+	worklist = arenaAlloc(&program.arena, nBlocks * sizeof(int));
+	queued = arenaAlloc(&program.arena, nBlocks);
+	if (blockUse == NULL || blockDef == NULL || liveIn == NULL || predStart == NULL
+		|| worklist == NULL || queued == NULL)
+	{
+		freeProgram(&program);		/* out of memory, already reported */
+		return 1;
+	}
+	memset(blockUse, 0, nBlocks * sizeof(unsigned int));
+	memset(blockDef, 0, nBlocks * sizeof(unsigned int));
+	memset(liveIn, 0, nBlocks * sizeof(unsigned int));
+	memset(predStart, 0, (nBlocks + 1) * sizeof(int));
+
+	/* Summarize each block, walking it backward. */
+	for (b = 0; b < nBlocks; b++)
+	{
+		for (i = blocks[b].end - 1; i >= blocks[b].start; i--)
+		{
+			instructionDefUse(program.words[i], &def, &use);
+			blockUse[b] = use | (blockUse[b] & ~def);
+			blockDef[b] |= def;
+		}
+	}
+
+	/* Predecessor lists, stored one after another (counted first). */
+	for (b = 0; b < nBlocks; b++)
+		for (k = 0; k < 2; k++)
+			if ((s = blocks[b].succ[k]) >= 0)
+				predStart[s + 1]++;
+	for (b = 0; b < nBlocks; b++)
+		predStart[b + 1] += predStart[b];
+	if ((preds = arenaAlloc(&program.arena, (predStart[nBlocks] + 1) * sizeof(int))) == NULL)
+	{
+		freeProgram(&program);
+		return 1;
+	}
+	for (b = 0; b < nBlocks; b++)
+		for (k = 0; k < 2; k++)
+			if ((s = blocks[b].succ[k]) >= 0)
+				preds[predStart[s]++] = b;
+	for (b = nBlocks; b > 0; b--)		/* undo the advance of each start */
+		predStart[b] = predStart[b - 1];
+	predStart[0] = 0;
+
+	/* Solve, starting from the last block since liveness flows backward. */
+	for (b = 0; b < nBlocks; b++)
+	{
+		worklist[b] = b;
+		queued[b] = 1;
+	}
+	top = nBlocks;
+
+	while (top > 0)
+	{
+		b = worklist[--top];
+		queued[b] = 0;
+		visits++;
+
+		out = exitLive(&program, &blocks[b]);
+		for (k = 0; k < 2; k++)
+			if ((s = blocks[b].succ[k]) >= 0)
+				out |= liveIn[s];
+
+		in = blockUse[b] | (out & ~blockDef[b]);
+		if (in == liveIn[b])
+			continue;
+
+		liveIn[b] = in;
+		for (k = predStart[b]; k < predStart[b + 1]; k++)
+		{
+			if (!queued[preds[k]])
+			{
+				queued[preds[k]] = 1;
+				worklist[top++] = preds[k];
+			}
+		}
+	}
+
+	if (strcmp(report, "lines") == 0)
+		status = !printLines(&program, blocks, nBlocks, liveIn);
+	else
+		printSummary(&program, blocks, nBlocks, liveIn, visits);
+
+	freeProgram(&program);
+	return status;
+}
+
+/* Prints the "lines" report.  Returns: 1, or 0 if there was not enough
+ * memory (already reported).
+ */
+static int printLines(Program * program, const BasicBlock * blocks, int nBlocks,
+					  const unsigned int liveIn[])
+{
+	unsigned int * liveAfter;
+	int longest = 0;
+	int lastDef[32];
+	unsigned int def, use, live;
+	char text[FORMAT_LIMIT];
+	char defs[32 * 7];
+	char uses[32 * 20];
+	char lives[32 * 7];
+	char * cursor;
+	int b, i, r, s, k;
+
+	for (b = 0; b < nBlocks; b++)
+		if (blocks[b].end - blocks[b].start > longest)
+			longest = blocks[b].end - blocks[b].start;
+	if ((liveAfter = arenaAlloc(&program->arena, longest * sizeof(unsigned int))) == NULL)
+		return 0;
+
+	for (b = 0; b < nBlocks; b++)
+	{
+		const BasicBlock * block = &blocks[b];
+
+		/* Backward: the registers live after each instruction. */
+		live = exitLive(program, block);
+		for (k = 0; k < 2; k++)
+			if ((s = block->succ[k]) >= 0)
+				live |= liveIn[s];
+		for (i = block->end - 1; i >= block->start; i--)
+		{
+			liveAfter[i - block->start] = live;
+			instructionDefUse(program->words[i], &def, &use);
+			live = use | (live & ~def);
+		}
+
+		/* Forward: where each use was defined. */
+		for (r = 0; r < 32; r++)
+			lastDef[r] = -1;
+		for (i = block->start; i < block->end; i++)
+		{
+			instructionDefUse(program->words[i], &def, &use);
+
+			cursor = uses;
+			*cursor = '\0';
+			for (r = 1; r < 32; r++)
+			{
+				if (!(use & BIT(r)))
+					continue;
+				if (lastDef[r] < 0)
+					cursor += sprintf(cursor, " %s@in", getRegName(r));
+				else
+					cursor += sprintf(cursor, " %s@%d", getRegName(r), program->lineNums[lastDef[r]]);
+			}
+			for (r = 1; r < 32; r++)
+				if (def & BIT(r))
+					lastDef[r] = i;
+
+			registerList(defs, def);
+			registerList(lives, liveAfter[i - block->start]);
+			formatInstruction(program->words[i], text);
+			printf("Line %d: %-26s def%s  use%s  live%s\n",
+				   program->lineNums[i], text, defs, uses, lives);
+		}
+	}
+	return 1;
+}
+
+static void printSummary(const Program * program, const BasicBlock * blocks, int nBlocks,
+						 const unsigned int liveIn[], long visits)
+{
+	int firstWrite[32];
+	int pendingWrite[32];
+	unsigned int def, use, word;
+	unsigned int written = 0;		/* clobbered */
+	unsigned int saved = 0;			/* on the stack since the last return */
+	unsigned int pending = 0;		/* saved, then written, not yet restored */
+	unsigned int restored = 0;
+	int returning = 0;				/* the last instruction was jr $ra */
+	int edges = 0;
+	char list[32 * 7];
+	int b, i, r;
+
+	for (b = 0; b < nBlocks; b++)
+		edges += (blocks[b].succ[0] >= 0) + (blocks[b].succ[1] >= 0);
+
+	for (i = 0; i <= program->count; i++)
+	{
+		/* After the delay slot of a return, and at the end, what was
+		 * written and not restored has been clobbered.
+		 */
+		if (returning || i == program->count)
+		{
+			for (r = 0; r < 32; r++)
+				if (pending & ~written & BIT(r))
+					firstWrite[r] = pendingWrite[r];
+			written |= pending;
+			saved = pending = 0;
+			returning = 0;
+		}
+		if (i == program->count)
+			break;
+
+		word = program->words[i];
+		instructionDefUse(word, &def, &use);
+		def &= CALLEE_SAVED;
+		if (OPCODE(word) == 43 && RS(word) == REG_SP && (BIT(RT(word)) & CALLEE_SAVED & ~pending))
+			saved |= BIT(RT(word));							/* sw reg, k($sp) */
+		else if (OPCODE(word) == 35 && RS(word) == REG_SP && (def & saved))
+		{
+			restored |= def & pending;						/* lw reg, k($sp) */
+			pending &= ~def;
+			def = 0;
+		}
+
+		for (r = 0; r < 32; r++)
+		{
+			if (def & saved & ~pending & BIT(r))
+				pendingWrite[r] = program->lineNums[i];
+			else if (def & ~saved & ~written & BIT(r))
+				firstWrite[r] = program->lineNums[i];
+		}
+		pending |= def & saved;
+		written |= def & ~saved;
+		returning = word == JR_RA;
+	}
+	restored &= ~written;
+
+	printf("Liveness: %d instructions, %d basic blocks, %d edges, %ld block visits\n",
+		   program->count, nBlocks, edges, visits);
+	registerList(list, liveIn[0]);
+	printf("Live on entry:%s\n", list);
+
+	printf("Callee-saved registers written:");
+	if (written == 0)
+		printf(" none");
+	for (r = 0; r < 32; r++)
+		if (written & BIT(r))
+			printf(" %s (line %d)", getRegName(r), firstWrite[r]);
+	printf("\n");
+
+	registerList(list, restored);
+	printf("Callee-saved registers saved and restored:%s\n", restored != 0 ? list : " none");
+}
+
+/* The registers live where control leaves the program from block. */
+static unsigned int exitLive(const Program * program, const BasicBlock * block)
+{
+	unsigned int last = program->words[block->end - 1];
+
+	if (!block->exits)
+		return 0;
+
+	if (OPCODE(last) == 0 && FUNCT(last) == 8 && RS(last) == 31)	/* jr $ra */
+		return RETURN_LIVE;
+
+	return ALL_REGISTERS;
+}
+
+/* Writes " $r1 $r2 ..." for the registers in set. */
+static char * registerList(char * text, unsigned int set)
+{
+	char * cursor = text;
+	int r;
+
+	*cursor = '\0';
+	for (r = 1; r < 32; r++)
+		if (set & BIT(r))
+			cursor += sprintf(cursor, " %s", getRegName(r));
+
+	return text;
+}
@@ -0,0 +1,126 @@
+/*
+ * mipsBatch
+ *
+ * These functions are the batch API of libmipsdis: each call decodes or
+ * formats a whole array of instruction words, so a caller in another
+ * language (Python, Go, Rust, ...) crosses the foreign function boundary
+ * once per array instead of once per instruction.
+ *
+ * size_t mips_decode_batch(const uint32_t * words, size_t n, mips_insn * out)
+ *   Post-condition: out[i] holds the fields of words[i], for i < n
+ *   Returns: n.
+ *
+ * size_t mips_format_batch(const uint32_t * words, size_t n, char * arena,
+ *                          size_t arenaSize, size_t * offsets)
+ *   Formats the words one after another into arena, each followed by a
+ *   null byte, as the disassembler prints them (unknown words give its
+ *   error message).  The text of words[i] starts at arena + offsets[i],
+ *   and offsets[k] is the end of the text, where k is the return value.
+ *   Pre-condition:  offsets has room for n + 1 entries
+ *   Returns: the number of words formatted, which is less than n only if
+ *            the arena filled up; an arena of n * MIPS_FORMAT_LIMIT
+ *            bytes is always enough.  The caller can continue with
+ *            words + k.
+ *
+ * const char * mips_mnemonic(uint8_t index)
+ *   Returns: the mnemonic of the instruction-table entry index (the
+ *            index field of a mips_insn), or NULL for MIPS_UNKNOWN.
+ *
+ * int mips_set_immediate_style(const char * style)
+ *   Same as the --imm option: "dec", "signed" or "hex".  Returns 1, or 0
+ *   if style is unknown.  Affects later calls to mips_format_batch.
+ *
+ * None of the functions prints a message or exits; errors are only
+ * returned, so the library can be loaded into a long-running host.
+ *
+ * All the functions may be called from several threads at once, except
+ * mips_set_immediate_style, which should be called before the others.
+ *
+ * Implementation:
+ *      mips_decode_batch runs two loops.  The first pulls out the fields
+ *      with shifts and masks only, with no calls and no branches, so the
+ *      compiler vectorizes it (the library is built with -O3; compile
+ *      with -fopt-info-vec to see it).  The second fills in the table
+ *      index and layout, which needs a table lookup per word and so is
+ *      kept out of the vectorized loop.
+ *
+ *      The lookup tables are constant (see instructionTable.c), so any
+ *      number of threads can use them.  The library is built with hidden
+ *      visibility, so only the functions marked MIPS_API are exported.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <string.h>
+
+#include "printFuncs.h"
+#include "mipsInstructions.h"
+#include "mipsBatch.h"
+
+_Static_assert(MIPS_FORMAT_LIMIT == FORMAT_LIMIT, "MIPS_FORMAT_LIMIT must match FORMAT_LIMIT");
+_Static_assert((int)MIPS_LAYOUT_R3 == LAYOUT_R3 && (int)MIPS_LAYOUT_SHIFT == LAYOUT_SHIFT
+			   && (int)MIPS_LAYOUT_JR == LAYOUT_JR && (int)MIPS_LAYOUT_ARITH == LAYOUT_ARITH
+			   && (int)MIPS_LAYOUT_BRANCH == LAYOUT_BRANCH && (int)MIPS_LAYOUT_LUI == LAYOUT_LUI
+			   && (int)MIPS_LAYOUT_MEM == LAYOUT_MEM && (int)MIPS_LAYOUT_JUMP == LAYOUT_JUMP,
+			   "the MIPS_LAYOUT_ values must match the LAYOUT_ values");
+
+MIPS_API size_t mips_decode_batch(const uint32_t * restrict words, size_t n, mips_insn * restrict out)
+{
+	const InstrInfo * instr;
+	size_t i;
+
+	for (i = 0; i < n; i++)
+	{
+		uint32_t word = words[i];
+
+		out[i].word = word;
+		out[i].target = TARGET(word);
+		out[i].simm = (int16_t)IMM(word);
+		out[i].imm = (uint16_t)IMM(word);
+		out[i].opcode = (uint8_t)OPCODE(word);
+		out[i].rs = (uint8_t)RS(word);
+		out[i].rt = (uint8_t)RT(word);
+		out[i].rd = (uint8_t)RD(word);
+		out[i].shamt = (uint8_t)SHAMT(word);
+		out[i].funct = (uint8_t)FUNCT(word);
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		instr = findInstruction(words[i]);
+		out[i].index = instr ? (uint8_t)(instr - instructionTable) : MIPS_UNKNOWN;
+		out[i].layout = instr ? (uint8_t)instr->layout : 0;
+	}
+
+	return n;
+}
+
+MIPS_API size_t mips_format_batch(const uint32_t * words, size_t n, char * arena,
+								  size_t arenaSize, size_t * offsets)
+{
+	size_t used = 0;
+	size_t i;
+	int length;
+
+	for (i = 0; i < n && arenaSize - used >= MIPS_FORMAT_LIMIT; i++)
+	{
+		offsets[i] = used;
+		length = formatInstruction(words[i], arena + used);
+		if (length < 0)
+			length = (int)strlen(arena + used);
+		used += (size_t)length + 1;
+	}
+
+	offsets[i] = used;
+	return i;
+}
+
+MIPS_API const char * mips_mnemonic(uint8_t index)
+{
+	return index < INSTRUCTION_COUNT ? instructionTable[index].name : NULL;
+}
+
+MIPS_API int mips_set_immediate_style(const char * style)
+{
+	return setImmediateStyle(style);
+}
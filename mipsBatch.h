@@ -0,0 +1,61 @@
+/*
+ * This file is the public interface of libmipsdis, the disassembler's
+ * batch API for callers in other languages (see mipsBatch.c).  It is
+ * self-contained so bindings can be generated from it directly.
+ */
+
+#ifndef _MIPS_BATCH_H
+#define _MIPS_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIPS_FORMAT_LIMIT	32		/* most bytes one instruction's text needs */
+#define MIPS_UNKNOWN		0xFF	/* index of a word that is not an instruction */
+
+#define MIPS_API __attribute__((visibility("default")))
+
+/* Operand layouts, the layout field of a mips_insn. */
+enum
+{
+	MIPS_LAYOUT_R3,		/* add  rd, rs, rt       */
+	MIPS_LAYOUT_SHIFT,	/* sll  rd, rt, shamt    */
+	MIPS_LAYOUT_JR,		/* jr   rs               */
+	MIPS_LAYOUT_ARITH,	/* addi rt, rs, imm      */
+	MIPS_LAYOUT_BRANCH,	/* beq  rs, rt, imm      */
+	MIPS_LAYOUT_LUI,	/* lui  rt, imm          */
+	MIPS_LAYOUT_MEM,	/* lw   rt, imm(rs)      */
+	MIPS_LAYOUT_JUMP	/* j    address          */
+};
+
+typedef struct
+{
+	uint32_t word;		/* the instruction word */
+	uint32_t target;	/* jump target field (26 bits) */
+	int32_t  simm;		/* immediate, sign-extended */
+	uint16_t imm;		/* immediate, zero-extended */
+	uint8_t  opcode;
+	uint8_t  rs;
+	uint8_t  rt;
+	uint8_t  rd;
+	uint8_t  shamt;
+	uint8_t  funct;
+	uint8_t  index;		/* position in the instruction table, or MIPS_UNKNOWN */
+	uint8_t  layout;	/* operand layout (MIPS_LAYOUT_ value), if index is valid */
+} mips_insn;
+
+MIPS_API size_t mips_decode_batch(const uint32_t * words, size_t n, mips_insn * out);
+MIPS_API size_t mips_format_batch(const uint32_t * words, size_t n, char * arena,
+								  size_t arenaSize, size_t * offsets);
+MIPS_API const char * mips_mnemonic(uint8_t index);
+MIPS_API int mips_set_immediate_style(const char * style);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
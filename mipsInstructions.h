@@ -0,0 +1,67 @@
+/*
+ * This file describes MIPS instructions as packed 32-bit words: macros
+ * for pulling the fields out of a word, the table of instructions the
+ * disassembler knows about, and the functions that convert between the
+ * 32 character '0'/'1' strings and packed words.
+ *
+ * The fields are laid out the same way as described in README.txt:
+ *
+ *      R Format:  opcode(6) rs(5) rt(5) rd(5) shamt(5) funct(6)
+ *      I Format:  opcode(6) rs(5) rt(5) immediate(16)
+ *      J Format:  opcode(6) address(26)
+ */
+
+#ifndef _MIPS_INSTRUCTIONS_H
+#define _MIPS_INSTRUCTIONS_H
+
+#include <stddef.h>
+
+#define OPCODE(w)	(((w) >> 26) & 0x3F)
+#define RS(w)		(((w) >> 21) & 0x1F)
+#define RT(w)		(((w) >> 16) & 0x1F)
+#define RD(w)		(((w) >> 11) & 0x1F)
+#define SHAMT(w)	(((w) >> 6) & 0x1F)
+#define FUNCT(w)	((w) & 0x3F)
+#define IMM(w)		((w) & 0xFFFF)
+#define TARGET(w)	((w) & 0x3FFFFFF)
+
+#define HASH_SIZE	64	/* slots in the mnemonic and register hash tables */
+#define FORMAT_LIMIT	32	/* room needed for one formatted instruction */
+
+/* Operand layouts, in the order processR, processI and processJ print them. */
+enum
+{
+	LAYOUT_R3,		/* add  rd, rs, rt       */
+	LAYOUT_SHIFT,	/* sll  rd, rt, shamt    */
+	LAYOUT_JR,		/* jr   rs               */
+	LAYOUT_ARITH,	/* addi rt, rs, imm      */
+	LAYOUT_BRANCH,	/* beq  rs, rt, imm      */
+	LAYOUT_LUI,		/* lui  rt, imm          */
+	LAYOUT_MEM,		/* lw   rt, imm(rs)      */
+	LAYOUT_JUMP		/* j    address          */
+};
+
+typedef struct
+{
+	const char * name;	/* mnemonic, e.g. "add" */
+	char format;		/* 'R', 'I' or 'J' */
+	int  opcode;
+	int  funct;			/* R format only; -1 otherwise */
+	int  layout;		/* one of the LAYOUT_ values above */
+} InstrInfo;
+
+extern const InstrInfo instructionTable[];
+extern const int INSTRUCTION_COUNT;
+
+const InstrInfo * findInstruction(unsigned int word);
+const InstrInfo * findInstructionByName(const char * name);
+unsigned int perfectHash(const char * s, size_t length, const unsigned int k[4]);
+
+unsigned int packMIPSInstruction(char string[]);
+void unpackMIPSInstruction(unsigned int word, char string[]);
+int formatInstruction(unsigned int word, char text[]);
+int setImmediateStyle(const char * style);
+int formatPseudoInstruction(unsigned int word, char text[]);
+int formatPseudoPair(unsigned int first, unsigned int second, char text[]);
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * packMIPSInstruction
+ *
+ * These functions convert between the 32 character '0'/'1' strings
+ * read by the disassembler and packed 32-bit instruction words, so
+ * that modes which look at many instructions can work on the words
+ * (and their fields, see mipsInstructions.h) instead of calling
+ * binToDec on the string over and over.
+ *
+ *   unsigned int packMIPSInstruction(char string[])
+ *      Pre-condition:  string has passed verifyMIPSInstruction
+ *      Returns: the instruction as a 32-bit word, string[0] being
+ *               the most significant bit.
+ *
+ *   void unpackMIPSInstruction(unsigned int word, char string[])
+ *      Pre-condition:  string has room for 33 characters
+ *      Post-condition: string holds the 32 '0'/'1' characters of word
+ *               followed by a null byte.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "mipsInstructions.h"
+
+unsigned int packMIPSInstruction(char string[])
+{
+	unsigned int word = 0;
+	int i;
+
+	for (i = 0; i < 32; i++)
+	{
+		word = (word << 1) | (unsigned int)(string[i] - '0');
+	}
+
+	return word;
+}
+
+void unpackMIPSInstruction(unsigned int word, char string[])
+{
+	int i;
+
+	for (i = 31; i >= 0; i--)
+	{
+		string[i] = '0' + (word & 1);
+		word >>= 1;
+	}
+
+	string[32] = '\0';
+}
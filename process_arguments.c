@@ -6,14 +6,77 @@
  * encounters a fatal error.
  *
  * Usage:
- *      programName  [filename] [0|1]
+ *      programName  [options] [filename] [0|1]
  * If both a filename and a debugging choice are provided, they may
  * be in either order.
  *
+ * Options start with "--" and may appear anywhere on the command line.
+ * Options that take a value accept either "--name=value" or
+ * "--name value".  They are recorded in the global options structure
+ * (see process_arguments.h):
+ *      --match pattern   print only instructions matching pattern, e.g.
+ *                        'mnemonic=sw,rs=$sp' or a raw 'mask/value' pair
+ *      --simulate        run the program instead of disassembling it
+ *      --base address    address of the first instruction (0x00400000)
+ *      --max-steps n     stop a simulation after about n instructions
+ *      --format name     assembler output format: bin, hex or raw
+ *      --strict          assembler only accepts immediates in the range
+ *                        the instruction uses
+ *      --verify-roundtrip  check that each printed instruction assembles
+ *                        back to the word it came from
+ *      --threads n       number of worker threads (default: one per CPU)
+ *      --imm style       print immediates as dec (default), signed or hex
+ *      --pseudo          print nop, move, li, la, b, beqz and bnez
+ *      --liveness report register def-use and liveness: lines or summary
+ *      --serve path      serve requests on a Unix domain socket
+ *      --socket path     (disclient, disbench) the server's socket
+ *      --requests n      (disbench) requests sent by each client
+ *      --batch n         (disclient, disbench) instructions per request
+ *      --store file      save the decoded fields in a column store file,
+ *                        or with --query, the store to query
+ *      --query pattern   print the instructions matching pattern (as for
+ *                        --match) using the column store
+ *      --count           with --query, print only the number of matches
+ *      --diff old        compare the program in file old with the input
+ *      --collapse n      print runs of n or more identical lines as one
+ *                        range of lines
+ *      --check           only count the valid, bad and unknown lines
+ *      --max-errors n    (--check) stop after n bad or unknown lines
+ *      --show n          (--check) list the first n of them (default 10)
+ *      --xref file       save a cross-reference index in file, or with
+ *                        --refs, the index to look in
+ *      --refs key        print the lines recorded under key, such as
+ *                        'target=0x00400120' or 'writes=$t0'
+ *      --resolve         print loads, stores and jr with the addresses
+ *                        known constants give them
+ *      --gp value        (--resolve) the value $gp holds
+ *      --callgraph fmt   print the calls between functions as dot or csv
+ *      --functions       print where functions start and end, with their
+ *                        stack frames and saved registers
+ *      --out file        write the output to file, compressed with gzip
+ *                        (file.gz) or zstd (file.zst)
+ *      --input fmt       read the input as auto (the default: as its first
+ *                        bytes look), bin, hex, raw, elf, ihex, srec, memh
+ *                        or memb; images are listed by address
+ *      --endian order    byte order of ihex, srec and raw words
+ *      --max-memory n    most bytes a loaded program (--liveness,
+ *                        --resolve, --store) and its analysis may use,
+ *                        not counting the --store columns
+ *      --memory          print how much memory the loaded program used
+ *      --dict file       save the listing as a dictionary of distinct
+ *                        instructions and an index per line
+ *      --expand file     print a listing saved with --dict
+ *      --files list      disassemble each file named in the file list
+ *      --io backend      (--files, filebench) read the files with auto (the
+ *                        default), uring, threads or sync
+ *      --cold            (filebench) drop the files from the page cache
+ *                        before each run
+ *
  * The optional filename indicates the input file; if it is provided,
  * process_arguments opens the file and returns it after also processing
  * the debugging option.  If it is not provided, the program reads its
- * input from stdin.
+ * input from stdin.  Either way, gzip (or zstd) compressed input is
+ * decompressed on the fly when it is read (see lineReader.c).
  *
  * A debugging choice argument of 0 or 1 indicates a choice to globally
  * turn debugging off or on, overriding any calls to debug_on,
@@ -31,10 +94,28 @@
 static const int SAME;	/* useful for making strcmp readable */
                                 /* e.g., if (strcmp (str1, str2) == SAME) */
 
+Options options = {
+    .textBase = 0x00400000,
+    .maxSteps = 100000000
+};
+
+static int process_options(int argc, char * argv[]);
+static char * option_value(int argc, char * argv[], int * i, const char * name);
+static int parse_number(const char * text, unsigned long * number);
+
 FILE * process_arguments(int argc, char * argv[])
 {
     FILE * fptr;               /* file pointer */
 
+    /* Handle the "--" options first and remove them from the argument
+     * list, so that the code below only sees the filename and the
+     * debugging choice.
+     */
+    if ( (argc = process_options(argc, argv)) < 0 )
+    {
+        return NULL;
+    }
+
     /* Implementation notes:
      * The arguments are both optional and may be provided in either
      * order, which makes the logic more complicated.  This function
@@ -96,7 +177,7 @@ FILE * process_arguments(int argc, char * argv[])
      */
     if ( argc > 2 )
     {
-        printError("Usage:  %s [filename] [0|1]\n", argv[0]);
+        printError("Usage:  %s [options] [filename] [0|1]\n", argv[0]);
         return 0;
     }
 
@@ -115,3 +196,235 @@ FILE * process_arguments(int argc, char * argv[])
 
     return fptr;   /* Everything was OK! */
 }
+
+/* Records each "--" option in the options structure and compacts the
+ * remaining arguments to the front of argv.  Returns the new argument
+ * count, or -1 if an option is unknown or is missing its value.
+ */
+static int process_options(int argc, char * argv[])
+{
+    int    i;
+    int    kept = 1;           /* argv[0] is always kept */
+    char * value;
+
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( strncmp(argv[i], "--", 2) != SAME )
+        {
+            argv[kept++] = argv[i];
+        }
+        else if ( (value = option_value(argc, argv, &i, "--match")) != NULL )
+        {
+            options.matchPattern = value;
+        }
+        else if ( strcmp(argv[i], "--simulate") == SAME )
+        {
+            options.simulate = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--base")) != NULL )
+        {
+            if ( !parse_number(value, &options.textBase) )
+                return -1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--max-steps")) != NULL )
+        {
+            if ( !parse_number(value, &options.maxSteps) )
+                return -1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--format")) != NULL )
+        {
+            options.format = value;
+        }
+        else if ( strcmp(argv[i], "--strict") == SAME )
+        {
+            options.strict = 1;
+        }
+        else if ( strcmp(argv[i], "--verify-roundtrip") == SAME )
+        {
+            options.verifyRoundTrip = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--threads")) != NULL )
+        {
+            if ( !parse_number(value, &options.threads) )
+                return -1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--imm")) != NULL )
+        {
+            options.immStyle = value;
+        }
+        else if ( strcmp(argv[i], "--pseudo") == SAME )
+        {
+            options.pseudo = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--liveness")) != NULL )
+        {
+            options.liveness = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--serve")) != NULL )
+        {
+            options.serve = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--socket")) != NULL )
+        {
+            options.socketPath = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--requests")) != NULL )
+        {
+            if ( !parse_number(value, &options.requests) )
+                return -1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--batch")) != NULL )
+        {
+            if ( !parse_number(value, &options.batch) )
+                return -1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--store")) != NULL )
+        {
+            options.store = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--query")) != NULL )
+        {
+            options.query = value;
+        }
+        else if ( strcmp(argv[i], "--count") == SAME )
+        {
+            options.count = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--diff")) != NULL )
+        {
+            options.diff = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--collapse")) != NULL )
+        {
+            if ( !parse_number(value, &options.collapse) )
+                return -1;
+        }
+        else if ( strcmp(argv[i], "--check") == SAME )
+        {
+            options.check = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--max-errors")) != NULL )
+        {
+            if ( !parse_number(value, &options.maxErrors) )
+                return -1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--show")) != NULL )
+        {
+            if ( !parse_number(value, &options.show) )
+                return -1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--xref")) != NULL )
+        {
+            options.xref = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--refs")) != NULL )
+        {
+            options.refs = value;
+        }
+        else if ( strcmp(argv[i], "--resolve") == SAME )
+        {
+            options.resolve = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--gp")) != NULL )
+        {
+            if ( !parse_number(value, &options.gp) )
+                return -1;
+            options.gpKnown = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--callgraph")) != NULL )
+        {
+            options.callGraph = value;
+        }
+        else if ( strcmp(argv[i], "--functions") == SAME )
+        {
+            options.functions = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--input")) != NULL )
+        {
+            options.inputFormat = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--endian")) != NULL )
+        {
+            options.endian = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--max-memory")) != NULL )
+        {
+            if ( !parse_number(value, &options.maxMemory) )
+                return -1;
+        }
+        else if ( strcmp(argv[i], "--memory") == SAME )
+        {
+            options.memoryReport = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--dict")) != NULL )
+        {
+            options.dict = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--expand")) != NULL )
+        {
+            options.expand = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--files")) != NULL )
+        {
+            options.files = value;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--io")) != NULL )
+        {
+            options.io = value;
+        }
+        else if ( strcmp(argv[i], "--cold") == SAME )
+        {
+            options.cold = 1;
+        }
+        else if ( (value = option_value(argc, argv, &i, "--out")) != NULL )
+        {
+            options.out = value;
+        }
+        else
+        {
+            printError("Error: Unknown option or missing value: %s\n", argv[i]);
+            return -1;
+        }
+    }
+
+    return kept;
+}
+
+/* If argv[*i] is the option "name", returns its value, which is either
+ * the text after '=' or the next argument (in which case *i is advanced
+ * past it).  Returns NULL if argv[*i] is a different option or has no
+ * value.
+ */
+static char * option_value(int argc, char * argv[], int * i, const char * name)
+{
+    size_t length = strlen(name);
+
+    if ( strncmp(argv[*i], name, length) != SAME )
+        return NULL;
+
+    if ( argv[*i][length] == '=' )
+        return argv[*i] + length + 1;
+
+    if ( argv[*i][length] == '\0' && *i + 1 < argc )
+        return argv[++*i];
+
+    return NULL;
+}
+
+/* Converts an option value (decimal, or hex with a leading 0x) into
+ * *number.  Returns 1 if it was a number, 0 (after printing an error
+ * message) if it was not.
+ */
+static int parse_number(const char * text, unsigned long * number)
+{
+    char * end;
+
+    *number = strtoul(text, &end, 0);
+    if ( *text == '\0' || *text == '-' || *end != '\0' )
+    {
+        printError("Error: %s is not a valid number.\n", text);
+        return 0;
+    }
+
+    return 1;
+}
@@ -1,15 +1,66 @@
 /*
- * This file provides the signature for the process_arguments function.
+ * This file provides the signature for the process_arguments function
+ * and the Options structure it fills in from "--name" style options.
  */
 
 #ifndef _PROCESS_ARGUMENTS_H
 #define _PROCESS_ARGUMENTS_H
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "printFuncs.h"
 
+typedef struct
+{
+    char * matchPattern;    /* --match: print only matching instructions */
+    int    simulate;        /* --simulate: run the program */
+    unsigned long textBase; /* --base: address of the first instruction */
+    unsigned long maxSteps; /* --max-steps: simulation step limit */
+    char * format;          /* --format: assembler output format */
+    int    strict;          /* --strict: assembler immediate range checks */
+    int    verifyRoundTrip; /* --verify-roundtrip: re-assemble and compare */
+    unsigned long threads;  /* --threads: worker threads (0 = one per CPU) */
+    char * immStyle;        /* --imm: immediate style, dec, signed or hex */
+    int    pseudo;          /* --pseudo: print pseudo-instructions */
+    char * liveness;        /* --liveness: register liveness report */
+    char * serve;           /* --serve: socket path to serve requests on */
+    char * socketPath;      /* --socket: server socket for the clients */
+    unsigned long requests; /* --requests: requests per benchmark client */
+    unsigned long batch;    /* --batch: instructions per client request */
+    char * store;           /* --store: column store file */
+    char * query;           /* --query: pattern to look up in the store */
+    int    count;           /* --count: print only the number of matches */
+    char * diff;            /* --diff: old program to compare the input with */
+    unsigned long collapse; /* --collapse: shortest run printed as a range */
+    int    check;           /* --check: only validate the input */
+    unsigned long maxErrors; /* --max-errors: stop checking after this many */
+    unsigned long show;     /* --show: bad lines listed by --check */
+    char * xref;            /* --xref: cross-reference index file */
+    char * refs;            /* --refs: key to look up in the index */
+    int    resolve;         /* --resolve: print resolved load/store addresses */
+    unsigned long gp;       /* --gp: value of $gp for --resolve */
+    int    gpKnown;         /* 1 if --gp was given */
+    char * callGraph;       /* --callgraph: call graph format, dot or csv */
+    int    functions;       /* --functions: find functions and their frames */
+    char * inputFormat;     /* --input: input format, or NULL to sniff it */
+    char * endian;          /* --endian: byte order of ihex, srec, raw words */
+    unsigned long maxMemory; /* --max-memory: bytes a loaded program may use */
+    int    memoryReport;    /* --memory: print the memory a program used */
+    char * dict;            /* --dict: save the listing dictionary-encoded */
+    char * expand;          /* --expand: print a listing saved by --dict */
+    char * files;           /* --files: list of files to disassemble */
+    char * io;              /* --io: how --files reads them */
+    int    cold;            /* --cold: (filebench) drop the files from the cache */
+    char * out;             /* --out: write the output compressed to this file */
+} Options;
+
+extern Options options;
+
 FILE * process_arguments(int argc, char * argv[]);
+int isCompressed(const unsigned char * data, size_t length);
+int decompressInput(int fd, const unsigned char * prefix, size_t length);
+int decompressFailed(void);
 
 #endif
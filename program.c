@@ -0,0 +1,447 @@
+/*
+ * program
+ *
+ * These functions load a whole program into memory and divide it into
+ * basic blocks, for the modes that analyze the program as a whole
+ * rather than one instruction at a time.
+ *
+ * int loadProgram(LineReader * reader, Program * program)
+ *   Reads the whole input.  The valid instructions are stored in
+ *   program->words, with their input lines in program->lineNums and
+ *   their addresses in program->addresses: those the image gives, or for
+ *   lines, as in the simulator, --base + 4 * i for words[i].  Invalid
+ *   lines are reported by verifyMIPSInstruction and left out.
+ *   Returns: 1, or 0 (after printing an error message) if the program
+ *            has no instructions, or does not fit in --max-memory bytes.
+ *
+ * void freeProgram(Program * program)
+ *   Frees everything loadProgram and the functions below allocated for
+ *   program.  With --memory, first prints how much memory that was, in
+ *   all and per instruction.
+ *
+ * int addSymbol(Program * program, unsigned int address, const char * name)
+ * const char * symbolAt(const Program * program, unsigned int address)
+ *   Give address a name (in place of any it had), and return the name of
+ *   address, or NULL if it has none.  addSymbol returns 0 (after printing
+ *   an error message) if it runs out of memory, and 1 otherwise.
+ *
+ * int annotate(Program * program, int index, const char * text)
+ * const char * annotationAt(const Program * program, int index)
+ *   Add text to the notes on instruction index (after a "; " if it has
+ *   some already), and return the notes on index, or NULL if it has none.
+ *   annotate returns 0 or 1 as addSymbol does.
+ *
+ * size_t programMemory(const Program * program)
+ *   Returns: the bytes of memory program holds.
+ *
+ * int branchTarget(const Program * program, int index)
+ *   Returns: the index of the instruction that the branch or jump at
+ *            index goes to, or -1 if it is not a branch or jump (jr has
+ *            no fixed target) or no instruction is at the target (it is
+ *            outside the program, or in a gap of an image).  The
+ *            addresses of an image with gaps must be in ascending order
+ *            for its targets to be found.
+ *
+ * int endsBasicBlock(unsigned int word)
+ *   Returns: 1 if word is a branch or jump, which ends a basic block.
+ *
+ * int findBasicBlocks(Program * program, BasicBlock ** blocks)
+ *   Post-condition: *blocks points to an array of the basic blocks, in
+ *                   program order, which freeProgram frees
+ *   Returns: the number of blocks.
+ *   A block starts at the first instruction, at every branch or jump
+ *   target, and after every branch or jump.  A block's successors are
+ *   the blocks that control can reach next: a branch has two, j has its
+ *   target, and jal is treated as a call that comes back to the next
+ *   instruction.  A block that ends in jr, jumps outside the program or
+ *   runs off its end is marked as exiting.
+ *
+ * Implementation:
+ *      The instructions are kept in three flat arrays, 12 bytes per
+ *      instruction, in address space reserved up front for the most
+ *      instructions --max-memory allows (or PROGRAM_RESERVE), so they
+ *      are never copied as the program grows; only the pages that are
+ *      filled take memory.  Everything else (symbols, notes, the text of
+ *      either, and the basic blocks) is allocated from an arena (see
+ *      arena.c) and freed with it in one go, so there is no malloc and
+ *      free per object and nothing to fragment.  Symbols and notes are
+ *      kept in hash tables of chains, since few instructions have them.
+ *
+ *      findBasicBlocks makes two linear passes: one marks the leaders in
+ *      a byte per instruction, the other walks the leaders to build the
+ *      blocks, using a block number per instruction to resolve the
+ *      targets.  Those 5 bytes per instruction come from the arena too,
+ *      so that --max-memory covers them, and stay there until the
+ *      program is freed.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "disassembler.h"
+
+#define LOAD_CHUNK 65536
+#define PROGRAM_RESERVE ((size_t)1 << 28)	/* instructions, without --max-memory */
+#define INSTRUCTION_BYTES (2 * sizeof(unsigned int) + sizeof(int))
+
+struct Note
+{
+	unsigned int key;		/* address of a symbol, index of a note */
+	const char * text;
+	Note * next;
+};
+
+static void * reserve(size_t bytes);
+static int indexOf(const Program * program, unsigned int address);
+static int putNote(Program * program, NoteTable * table, unsigned int key, const char * text);
+static Note * findNote(const NoteTable * table, unsigned int key);
+static unsigned int bucketOf(unsigned int key, unsigned int nBuckets);
+
+int loadProgram(LineReader * reader, Program * program)
+{
+	size_t capacity = options.maxMemory ? options.maxMemory / INSTRUCTION_BYTES : PROGRAM_RESERVE;
+	size_t chunk, room;
+	unsigned int extra;
+	unsigned int next = (unsigned int)options.textBase;
+	int lineNum = 0;
+	int count;
+
+	if (capacity > INT32_MAX)
+		capacity = INT32_MAX;
+	memset(program, 0, sizeof(Program));
+	program->capacity = capacity;
+	program->words = reserve(capacity * sizeof(unsigned int));
+	program->lineNums = reserve(capacity * sizeof(int));
+	program->addresses = reserve(capacity * sizeof(unsigned int));
+	if (program->words == NULL || program->lineNums == NULL || program->addresses == NULL)
+	{
+		printError("Error: Cannot reserve memory for %zu instructions (see --max-memory).\n",
+				   capacity);
+		freeProgram(program);
+		return 0;
+	}
+
+	do
+	{
+		chunk = capacity - (size_t)program->count;
+		count = readAddressBlock(reader, program->words + program->count,
+								 program->addresses + program->count,
+								 program->lineNums + program->count,
+								 chunk < LOAD_CHUNK ? (int)chunk : LOAD_CHUNK, &lineNum, &next);
+		program->count += count;
+	} while (count > 0);
+
+	if ((size_t)program->count == capacity
+		&& readWordBlock(reader, &extra, &count, 1, &lineNum) > 0)
+	{
+		printError("Error: The program has more than %zu instructions (see --max-memory).\n",
+				   capacity);
+		freeProgram(program);
+		return 0;
+	}
+
+	if (program->count == 0)
+	{
+		printError("Error: The program has no instructions.\n");
+		freeProgram(program);
+		return 0;
+	}
+	program->base = program->addresses[0];
+
+	/* The arena gets what the instructions leave of --max-memory (a
+	 * limit of 0 would be no limit, so at least 1 byte).
+	 */
+	room = options.maxMemory - (size_t)program->count * INSTRUCTION_BYTES;
+	initArena(&program->arena, options.maxMemory == 0 ? 0 : room > 0 ? room : 1);
+	return 1;
+}
+
+void freeProgram(Program * program)
+{
+	size_t bytes = programMemory(program);
+
+	if (options.memoryReport && program->count > 0)
+	{
+		printf("Program memory: %d instructions, %zu bytes (%.1f per instruction), "
+			   "%zu of them in the arena\n", program->count, bytes,
+			   (double)bytes / program->count, program->arena.bytes);
+	}
+
+	if (program->words != NULL)
+		munmap(program->words, program->capacity * sizeof(unsigned int));
+	if (program->lineNums != NULL)
+		munmap(program->lineNums, program->capacity * sizeof(int));
+	if (program->addresses != NULL)
+		munmap(program->addresses, program->capacity * sizeof(unsigned int));
+	freeArena(&program->arena);
+	program->words = NULL;
+	program->lineNums = NULL;
+	program->addresses = NULL;
+	program->count = 0;
+	program->symbols.buckets = program->notes.buckets = NULL;
+	program->symbols.nBuckets = program->notes.nBuckets = 0;
+	program->symbols.count = program->notes.count = 0;
+}
+
+int addSymbol(Program * program, unsigned int address, const char * name)
+{
+	return putNote(program, &program->symbols, address, name);
+}
+
+const char * symbolAt(const Program * program, unsigned int address)
+{
+	Note * note = findNote(&program->symbols, address);
+
+	return note != NULL ? note->text : NULL;
+}
+
+int annotate(Program * program, int index, const char * text)
+{
+	Note * note = findNote(&program->notes, (unsigned int)index);
+	const char * joined;
+
+	if (note == NULL)
+		return putNote(program, &program->notes, (unsigned int)index, text);
+
+	if ((joined = arenaPrintf(&program->arena, "%s; %s", note->text, text)) == NULL)
+		return 0;
+	note->text = joined;
+	return 1;
+}
+
+const char * annotationAt(const Program * program, int index)
+{
+	Note * note = findNote(&program->notes, (unsigned int)index);
+
+	return note != NULL ? note->text : NULL;
+}
+
+size_t programMemory(const Program * program)
+{
+	return (size_t)program->count * INSTRUCTION_BYTES + program->arena.bytes;
+}
+
+/* Returns bytes of address space, which take memory only when they are
+ * written, or NULL.
+ */
+static void * reserve(size_t bytes)
+{
+	void * p = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	return p == MAP_FAILED ? NULL : p;
+}
+
+/* Sets the text for key in table, copying text into the arena.  The
+ * bucket array doubles (in the arena too) when the table is as full as
+ * it has buckets.
+ */
+static int putNote(Program * program, NoteTable * table, unsigned int key, const char * text)
+{
+	Note ** buckets;
+	Note * note;
+	Note * next;
+	unsigned int nBuckets, b, i;
+	const char * copy;
+
+	if ((copy = arenaString(&program->arena, text)) == NULL)
+		return 0;
+	if ((note = findNote(table, key)) != NULL)
+	{
+		note->text = copy;
+		return 1;
+	}
+
+	if (table->count >= table->nBuckets)
+	{
+		nBuckets = table->nBuckets ? 2 * table->nBuckets : 256;
+		if ((buckets = arenaAlloc(&program->arena, nBuckets * sizeof(Note *))) == NULL)
+			return 0;
+		memset(buckets, 0, nBuckets * sizeof(Note *));
+		for (i = 0; i < table->nBuckets; i++)
+		{
+			for (note = table->buckets[i]; note != NULL; note = next)
+			{
+				next = note->next;
+				b = bucketOf(note->key, nBuckets);
+				note->next = buckets[b];
+				buckets[b] = note;
+			}
+		}
+		table->buckets = buckets;
+		table->nBuckets = nBuckets;
+	}
+
+	if ((note = arenaAlloc(&program->arena, sizeof(Note))) == NULL)
+		return 0;
+	b = bucketOf(key, table->nBuckets);
+	note->key = key;
+	note->text = copy;
+	note->next = table->buckets[b];
+	table->buckets[b] = note;
+	table->count++;
+	return 1;
+}
+
+static Note * findNote(const NoteTable * table, unsigned int key)
+{
+	Note * note;
+
+	if (table->nBuckets == 0)
+		return NULL;
+	for (note = table->buckets[bucketOf(key, table->nBuckets)]; note != NULL; note = note->next)
+	{
+		if (note->key == key)
+			return note;
+	}
+	return NULL;
+}
+
+static unsigned int bucketOf(unsigned int key, unsigned int nBuckets)
+{
+	return (unsigned int)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 32) & (nBuckets - 1);
+}
+
+int branchTarget(const Program * program, int index)
+{
+	unsigned int word = program->words[index];
+	unsigned int address = program->addresses[index];
+
+	switch (OPCODE(word))
+	{
+		case 2 : /* j */
+		case 3 : /* jal */
+			address = ((address + 4) & 0xF0000000) | (TARGET(word) << 2);
+		break;
+
+		case 4 : /* beq */
+		case 5 : /* bne */
+			address = address + 4 + ((unsigned int)(int)(short)IMM(word) << 2);
+		break;
+
+		default :
+			return -1;
+	}
+
+	return indexOf(program, address);
+}
+
+/* Returns the index of the instruction at address, or -1 if there is
+ * none.  Where the program has no gap before address, the index is
+ * worked out directly; otherwise it is found by binary search.
+ */
+static int indexOf(const Program * program, unsigned int address)
+{
+	unsigned int guess = (address - program->base) / 4;
+	int low = 0;
+	int high = program->count - 1;
+	int middle;
+
+	if (guess < (unsigned int)program->count && program->addresses[guess] == address)
+		return (int)guess;
+
+	while (low <= high)
+	{
+		middle = low + (high - low) / 2;
+		if (program->addresses[middle] == address)
+			return middle;
+		if (program->addresses[middle] < address)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+	return -1;
+}
+
+int findBasicBlocks(Program * program, BasicBlock ** blocks)
+{
+	unsigned char * leader = arenaAlloc(&program->arena, program->count + 1);
+	int * blockOf = arenaAlloc(&program->arena, program->count * sizeof(int));
+	BasicBlock * block;
+	int nBlocks = 0;
+	int target;
+	int last;
+	int i;
+
+	if (leader == NULL || blockOf == NULL)
+		return 0;
+	memset(leader, 0, program->count + 1);
+	leader[0] = 1;
+	leader[program->count] = 1;
+	for (i = 0; i < program->count; i++)
+	{
+		if (endsBasicBlock(program->words[i]))
+		{
+			leader[i + 1] = 1;
+			if ((target = branchTarget(program, i)) >= 0)
+				leader[target] = 1;
+		}
+	}
+
+	for (i = 0; i < program->count; i++)
+	{
+		nBlocks += leader[i];
+		blockOf[i] = nBlocks - 1;
+	}
+
+	*blocks = arenaAlloc(&program->arena, nBlocks * sizeof(BasicBlock));
+	if (*blocks == NULL)
+		return 0;
+	for (i = 0; i < program->count; i++)
+	{
+		if (!leader[i])
+			continue;
+
+		block = &(*blocks)[blockOf[i]];
+		block->start = i;
+		for (block->end = i + 1; !leader[block->end]; block->end++)
+			;
+
+		last = block->end - 1;
+		target = branchTarget(program, last);
+		block->succ[0] = block->end < program->count ? blockOf[block->end] : -1;
+		block->succ[1] = -1;
+		block->exits = block->end == program->count;
+
+		switch (OPCODE(program->words[last]))
+		{
+			case 0 :
+				if (FUNCT(program->words[last]) == 8)	/* jr */
+				{
+					block->succ[0] = -1;
+					block->exits = 1;
+				}
+			break;
+
+			case 2 : /* j */
+				block->succ[0] = target >= 0 ? blockOf[target] : -1;
+				block->exits = target < 0;
+			break;
+
+			case 4 : /* beq */
+			case 5 : /* bne */
+				block->succ[1] = target >= 0 ? blockOf[target] : -1;
+				block->exits |= target < 0;
+			break;
+		}
+	}
+
+	return nBlocks;
+}
+
+int endsBasicBlock(unsigned int word)
+{
+	switch (OPCODE(word))
+	{
+		case 0 :
+			return FUNCT(word) == 8;		/* jr */
+
+		case 2 : case 3 : case 4 : case 5 :	/* j, jal, beq, bne */
+			return 1;
+
+		default :
+			return 0;
+	}
+}
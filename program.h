@@ -0,0 +1,54 @@
+/*
+ * This file provides the program model, which holds a whole program in
+ * memory, and the signatures for loading it, naming and annotating its
+ * instructions, and dividing it into basic blocks (see program.c).
+ */
+
+#ifndef _PROGRAM_H
+#define _PROGRAM_H
+
+#include "lineReader.h"
+#include "arena.h"
+
+typedef struct Note Note;
+
+typedef struct
+{
+	Note ** buckets;		/* chains of notes, by key */
+	unsigned int nBuckets;	/* a power of 2, or 0 */
+	unsigned int count;
+} NoteTable;
+
+typedef struct
+{
+	unsigned int * words;	/* the valid instructions, in input order */
+	int * lineNums;			/* input line of each instruction */
+	unsigned int * addresses;	/* address of each instruction */
+	int count;				/* number of instructions */
+	unsigned int base;		/* address of words[0] */
+	size_t capacity;		/* instructions words and lineNums can hold */
+	Arena arena;			/* symbols, notes, text and basic blocks */
+	NoteTable symbols;		/* name of an address */
+	NoteTable notes;		/* annotation of an instruction */
+} Program;
+
+typedef struct
+{
+	int start;				/* index of the first instruction */
+	int end;				/* one past the index of the last one */
+	int succ[2];			/* successor blocks, or -1 */
+	int exits;				/* 1 if control can leave the program here */
+} BasicBlock;
+
+int loadProgram(LineReader * reader, Program * program);
+void freeProgram(Program * program);
+int addSymbol(Program * program, unsigned int address, const char * name);
+const char * symbolAt(const Program * program, unsigned int address);
+int annotate(Program * program, int index, const char * text);
+const char * annotationAt(const Program * program, int index);
+size_t programMemory(const Program * program);
+int branchTarget(const Program * program, int index);
+int endsBasicBlock(unsigned int word);
+int findBasicBlocks(Program * program, BasicBlock ** blocks);
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * pseudoInstructions
+ *
+ * This file implements the --pseudo option: the input is listed the
+ * same way the disassembler normally lists it, but instructions that
+ * are really pseudo-instructions are printed as such (see
+ * formatPseudoInstruction in formatInstruction.c), e.g.
+ *          Line 7: nop
+ *          Line 8: move $a0, $s0
+ * and a lui followed by the ori or addiu that completes its constant is
+ * printed once for both lines:
+ *          Line 9: 00111100000010000001001000110100
+ *          Line 10: 00110101000010000101011001111000
+ *          Lines 9-10: li $t0, 305419896
+ *
+ * int listPseudoInstructions(LineReader * reader)
+ *   Reads the whole input and prints the listing.
+ *   Returns: the exit status for main.
+ *
+ * Implementation:
+ *      The pass keeps a window of one line: a lui is held back until
+ *      the next line has been read.  If the two merge, both are printed
+ *      with the merged instruction; otherwise the lui is printed as
+ *      usual and the next line is handled on its own.  Everything else
+ *      is printed as soon as it is read, so the state never grows.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+
+#define INSTR_LENGTH 32			/* characters in an instruction line */
+
+typedef struct
+{
+	int  lineNum;				/* 0 if no lui is being held */
+	unsigned int word;
+	char input[INSTR_LENGTH + 1];
+} Pending;
+
+static int isBinary(const char * input, int length);
+static void printPending(Pending * pending);
+
+int listPseudoInstructions(LineReader * reader)
+{
+	Pending pending = { 0, 0, { 0 } };
+	char * input;
+	char text[FORMAT_LIMIT];
+	int  length;
+	int  lineNum = 0;
+	unsigned int word;
+
+	while ((input = readLine(reader, &length)) != NULL)
+	{
+		lineNum++;
+		word = isBinary(input, length) ? packMIPSInstruction(input) : 0;
+
+		if (pending.lineNum != 0)
+		{
+			if (isBinary(input, length) && formatPseudoPair(pending.word, word, text) >= 0)
+			{
+				printf("\nLine %d: %s\nLine %d: %s\nLines %d-%d: %s\n",
+					   pending.lineNum, pending.input, lineNum, input,
+					   pending.lineNum, lineNum, text);
+				pending.lineNum = 0;
+				continue;
+			}
+			printPending(&pending);
+		}
+
+		if (isBinary(input, length) && OPCODE(word) == 15)	/* lui */
+		{
+			pending.lineNum = lineNum;
+			pending.word = word;
+			memcpy(pending.input, input, INSTR_LENGTH + 1);
+			continue;
+		}
+
+		printf("\nLine %d: %s\n", lineNum, input);
+
+		if (verifyMIPSInstruction(lineNum, input) == 1)
+		{
+			if (formatPseudoInstruction(word, text) < 0)
+			{
+				incrementErrorCount();
+			}
+			printf("Line %d: %s\n", lineNum, text);
+			checkErrorCount();
+		}
+	}
+
+	if (pending.lineNum != 0)
+	{
+		printPending(&pending);
+	}
+
+	closeLineReader(reader);
+	return 0;
+}
+
+/* Returns 1 if input is a valid instruction line (checked quietly;
+ * verifyMIPSInstruction reports the lines that are not).
+ */
+static int isBinary(const char * input, int length)
+{
+	return length == INSTR_LENGTH && strspn(input, "01") == INSTR_LENGTH;
+}
+
+/* Prints the held lui as an ordinary line. */
+static void printPending(Pending * pending)
+{
+	char text[FORMAT_LIMIT];
+
+	formatInstruction(pending->word, text);
+	printf("\nLine %d: %s\nLine %d: %s\n",
+		   pending->lineNum, pending->input, pending->lineNum, text);
+	pending->lineNum = 0;
+}
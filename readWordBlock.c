@@ -0,0 +1,82 @@
+/*
+ * readWordBlock
+ *
+ * This function reads lines of input the same way the main disassembler
+ * loop does (with readLine), verifies each one with
+ * verifyMIPSInstruction, and packs the valid ones into 32-bit words.
+ * It is used by modes that work on blocks of packed words rather than
+ * one line at a time.
+ *
+ * int readWordBlock(LineReader * reader, unsigned int words[],
+ *                   int lineNums[], int max, int * lineNum)
+ *   Pre-condition:  words and lineNums have room for max entries;
+ *                   *lineNum is the number of lines read so far
+ *   Post-condition: words[0..n-1] hold the packed instructions and
+ *                   lineNums[0..n-1] the input line each came from;
+ *                   *lineNum has been advanced past every line read
+ *                   (valid or not)
+ *   Returns: n, the number of words stored; 0 only at end of file.
+ *   Output: Invalid lines are reported by verifyMIPSInstruction.
+ *   If the input is an image (see openInput in wordReader.c), the words
+ *   come from its word reader instead, and lineNums count words.
+ *
+ * int readAddressBlock(LineReader * reader, unsigned int words[],
+ *                      unsigned int addresses[], int lineNums[], int max,
+ *                      int * lineNum, unsigned int * address)
+ *   As readWordBlock, and also stores the address of each word in
+ *   addresses[0..n-1], for modes that work out branch and jump targets.
+ *   *address is the address of the next word read from lines: start it
+ *   at --base, and each valid line takes the next 4 bytes.  Words from an
+ *   image are at the addresses the image gives (which may have gaps),
+ *   and *address is left after the last of them.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+
+int readWordBlock(LineReader * reader, unsigned int words[], int lineNums[],
+				  int max, int * lineNum)
+{
+	unsigned int address = 0;
+
+	return readAddressBlock(reader, words, NULL, lineNums, max, lineNum, &address);
+}
+
+int readAddressBlock(LineReader * reader, unsigned int words[],
+					 unsigned int addresses[], int lineNums[], int max,
+					 int * lineNum, unsigned int * address)
+{
+	WordReader * image = wordSource(reader);
+	char * input;
+	int  length;
+	int  count = 0;
+	int  k;
+
+	if (image != NULL)
+	{
+		count = readWords(image, words, addresses, max);
+		for (k = 0; k < count; k++)
+			lineNums[k] = ++(*lineNum);
+		if (count > 0 && addresses != NULL)
+			*address = addresses[count - 1] + 4;
+		return count;
+	}
+
+	while (count < max && (input = readLine(reader, &length)) != NULL)
+	{
+		(*lineNum)++;
+
+		if (verifyMIPSInstruction(*lineNum, input) == 1)
+		{
+			words[count] = packMIPSInstruction(input);
+			lineNums[count] = *lineNum;
+			if (addresses != NULL)
+				addresses[count] = *address;
+			*address += 4;
+			count++;
+		}
+	}
+
+	return count;
+}
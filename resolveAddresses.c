@@ -0,0 +1,221 @@
+/*
+ * resolveAddresses
+ *
+ * This file implements the --resolve option: follow the registers that
+ * hold known constants through each basic block, so that the address a
+ * load, store or jr uses can be printed with it.  For example,
+ *          lui $at, 4097
+ *          lw $t0, 1200($at)
+ * loads from 0x100104b0, which is where a global variable would be.
+ *
+ * int resolveAddresses(LineReader * reader)
+ *   Reads the whole program and prints each lw, sw and jr whose address
+ *   is known, with the address, e.g.
+ *          Line 12: lw $t0, 1200($at)  [0x100104b0]
+ *          Line 40: jr $t9  -> 0x00400120 <sub_00400120>
+ *   then how many of them were resolved.  Every jal target is named
+ *   sub_ and its address, and an address with a name is printed with it.
+ *   Returns: the exit status for main (0 unless the program was empty).
+ *
+ * A register holds a known constant after
+ *      lui rt, imm                 imm << 16
+ *      ori rt, rs, imm             rs | imm
+ *      addiu (or addi) rt, rs, imm rs + imm (sign-extended)
+ *      addu, add or or rd, rs, rt  rs + rt or rs | rt
+ * when the registers it reads are known; $zero is always 0.  Any other
+ * instruction that writes a register (as instructionDefUse in liveness.c
+ * says, so jal clobbers the caller-saved registers) makes it unknown.
+ * With --gp value, $gp is known to hold value at the start of every
+ * block, as a program that sets it once at startup would have it.
+ *
+ * Implementation:
+ *      Values are tracked within basic blocks only (see findBasicBlocks
+ *      in program.c): at the start of a block every register but $zero
+ *      (and $gp, with --gp) is unknown.  The lattice for a block is a
+ *      fixed array of 32 values plus a 32-bit mask of the registers
+ *      whose value is known, so each instruction costs a constant amount
+ *      of work and the pass is linear in the size of the program.  The
+ *      jal targets are added to the program's symbols first, and each
+ *      address found is added to its instruction's notes (see program.c),
+ *      which are printed in program order at the end.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+
+#define BIT(r)		(1U << (r))
+#define GP			28
+
+typedef struct
+{
+	unsigned int value[32];
+	unsigned int known;		/* bit r is set if value[r] is known */
+} Constants;
+
+static void step(Constants * regs, unsigned int word);
+
+int resolveAddresses(LineReader * reader)
+{
+	Program program;
+	BasicBlock * blocks;
+	Constants regs;
+	char text[FORMAT_LIMIT];
+	char note[64];
+	const char * name;
+	unsigned int word;
+	unsigned int base;
+	unsigned int address;
+	long memory = 0, memoryResolved = 0;
+	long jumps = 0, jumpsResolved = 0;
+	int nBlocks;
+	int b, i;
+
+	if (!loadProgram(reader, &program))
+	{
+		return 1;
+	}
+	nBlocks = findBasicBlocks(&program, &blocks);
+	if (nBlocks == 0)
+	{
+		freeProgram(&program);		/* out of memory, already reported */
+		return 1;
+	}
+
+	for (i = 0; i < program.count; i++)
+	{
+		word = program.words[i];
+		if (OPCODE(word) != 3)										/* jal */
+			continue;
+		address = ((program.addresses[i] + 4) & 0xF0000000) | (TARGET(word) << 2);
+		sprintf(note, "sub_%08x", address);
+		if (!addSymbol(&program, address, note))
+		{
+			freeProgram(&program);	/* out of memory, already reported */
+			return 1;
+		}
+	}
+
+	for (b = 0; b < nBlocks; b++)
+	{
+		regs.known = BIT(0);
+		regs.value[0] = 0;
+		if (options.gpKnown)
+		{
+			regs.known |= BIT(GP);
+			regs.value[GP] = (unsigned int)options.gp;
+		}
+
+		for (i = blocks[b].start; i < blocks[b].end; i++)
+		{
+			word = program.words[i];
+			base = RS(word);
+			note[0] = '\0';
+
+			if (OPCODE(word) == 35 || OPCODE(word) == 43)			/* lw, sw */
+			{
+				memory++;
+				if (regs.known & BIT(base))
+				{
+					memoryResolved++;
+					address = regs.value[base] + (unsigned int)(int)(short)IMM(word);
+					sprintf(note, "[0x%08x]", address);
+				}
+			}
+			else if (OPCODE(word) == 0 && FUNCT(word) == 8)			/* jr */
+			{
+				jumps++;
+				if (regs.known & BIT(base))
+				{
+					jumpsResolved++;
+					address = regs.value[base];
+					sprintf(note, "-> 0x%08x", address);
+				}
+			}
+
+			if (note[0] != '\0')
+			{
+				if ((name = symbolAt(&program, address)) != NULL)
+					sprintf(note + strlen(note), " <%s>", name);
+				if (!annotate(&program, i, note))
+				{
+					freeProgram(&program);
+					return 1;
+				}
+			}
+			step(&regs, word);
+		}
+	}
+
+	for (i = 0; i < program.count; i++)
+	{
+		if ((name = annotationAt(&program, i)) != NULL)
+		{
+			formatInstruction(program.words[i], text);
+			printf("Line %d: %s  %s\n", program.lineNums[i], text, name);
+		}
+	}
+
+	printf("Resolved %ld of %ld loads and stores, %ld of %ld jr\n",
+		   memoryResolved, memory, jumpsResolved, jumps);
+
+	freeProgram(&program);
+	return 0;
+}
+
+/* Updates the known registers for the effect of one instruction. */
+static void step(Constants * regs, unsigned int word)
+{
+	unsigned int def, use;
+	unsigned int rs = RS(word);
+	unsigned int rt = RT(word);
+	unsigned int imm = IMM(word);
+	int dest = -1;
+	unsigned int value = 0;
+	int known = 0;
+
+	switch (OPCODE(word))
+	{
+		case 15 :											/* lui */
+			dest = (int)rt;
+			value = imm << 16;
+			known = 1;
+		break;
+
+		case 13 :											/* ori */
+			dest = (int)rt;
+			value = regs->value[rs] | imm;
+			known = (regs->known & BIT(rs)) != 0;
+		break;
+
+		case 8 :											/* addi */
+		case 9 :											/* addiu */
+			dest = (int)rt;
+			value = regs->value[rs] + (unsigned int)(int)(short)imm;
+			known = (regs->known & BIT(rs)) != 0;
+		break;
+
+		case 0 :
+			if (FUNCT(word) == 32 || FUNCT(word) == 33 || FUNCT(word) == 37)	/* add, addu, or */
+			{
+				dest = (int)RD(word);
+				value = FUNCT(word) == 37 ? regs->value[rs] | regs->value[rt]
+					: regs->value[rs] + regs->value[rt];
+				known = (regs->known & BIT(rs)) && (regs->known & BIT(rt));
+			}
+		break;
+	}
+
+	if (dest >= 0)
+	{
+		if (dest > 0)									/* $zero stays 0 */
+		{
+			regs->value[dest] = value;
+			regs->known = known ? regs->known | BIT(dest) : regs->known & ~BIT(dest);
+		}
+		return;
+	}
+
+	instructionDefUse(word, &def, &use);
+	regs->known &= ~(def & ~BIT(0));
+}
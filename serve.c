@@ -0,0 +1,603 @@
+/*
+ * serve
+ *
+ * This file implements the --serve option: instead of reading one input
+ * and exiting, the disassembler listens on a Unix domain socket and
+ * answers disassembly requests until it is stopped with SIGINT or
+ * SIGTERM.  The request and reply frames are described in
+ * serveProtocol.h; disclient is a command-line client and disbench a
+ * load generator.
+ *
+ * int serveRequests(const char * path)
+ *   Listens at path (replacing any socket already there) and serves
+ *   requests.  Returns: the exit status for main.
+ *
+ * Implementation:
+ *      The main thread runs an epoll loop over the listening socket, the
+ *      client connections and an eventfd.  It reads from connections
+ *      that are waiting for a request; once a whole frame has arrived,
+ *      the connection is handed to the worker pool (--threads, by
+ *      default one per processor) and the main thread stops watching it.
+ *      A worker formats the request into the connection's reply buffer,
+ *      puts the connection on the done list and signals the eventfd.
+ *      The main thread then sends the reply, watching for EPOLLOUT if
+ *      the socket is full, and starts on the next request already in
+ *      the buffer, if any.  Only one thread touches a connection at a
+ *      time, so the connections need no locks; only the two lists do.
+ *
+ *      Each connection keeps its request and reply buffers for its whole
+ *      life, growing them when a request needs more room, so a steady
+ *      stream of requests allocates nothing.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#define _GNU_SOURCE		/* for accept4 */
+
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "disassembler.h"
+#include "serveProtocol.h"
+
+#define MAX_THREADS	64
+#define MAX_EVENTS	64
+#define READ_SIZE	65536
+
+typedef struct Connection
+{
+	int fd;
+	int watched;				/* registered with epoll */
+	int closed;					/* the client has closed its end */
+	unsigned char * in;			/* bytes received, not yet answered */
+	size_t inLength;
+	size_t inCapacity;
+	unsigned char * out;		/* the reply being sent */
+	size_t outLength;
+	size_t outSent;
+	size_t outCapacity;
+	struct Connection * next;	/* in the job or done list */
+} Connection;
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	pthread_cond_t  ready;
+	Connection * jobs;			/* waiting for a worker */
+	Connection ** lastJob;
+	Connection * done;			/* replies ready to send */
+	int eventFd;
+	int stopping;
+} Pool;
+
+static Pool pool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+					 NULL, &pool.jobs, NULL, -1, 0 };
+static volatile sig_atomic_t stopRequested = 0;
+
+static int listenAt(const char * path);
+static void onSignal(int signalNumber);
+static void * worker(void * arg);
+static void answer(Connection * c);
+static int isBinaryLine(const unsigned char * line);
+static int reserve(Connection * c, size_t length);
+static void readRequest(int epollFd, Connection * c);
+static void startNext(int epollFd, Connection * c);
+static void sendReply(int epollFd, Connection * c);
+static void watch(int epollFd, Connection * c, unsigned int events);
+static void closeConnection(int epollFd, Connection * c);
+
+int serveRequests(const char * path)
+{
+	struct epoll_event events[MAX_EVENTS];
+	struct epoll_event event;
+	struct sigaction action;
+	sigset_t stopSignals;
+	pthread_t threads[MAX_THREADS];
+	long nThreads = (long)options.threads;
+	Connection * c;
+	Connection * done;
+	uint64_t signals;
+	int listenFd, epollFd, clientFd;
+	int n, i;
+
+	if (nThreads <= 0)
+		nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThreads < 1)
+		nThreads = 1;
+	if (nThreads > MAX_THREADS)
+		nThreads = MAX_THREADS;
+
+	if ((listenFd = listenAt(path)) < 0)
+		return 1;
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = onSignal;		/* no SA_RESTART: epoll_wait returns */
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	pool.eventFd = eventfd(0, EFD_NONBLOCK);
+	epollFd = epoll_create1(0);
+
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;					/* the listening socket */
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+	event.data.ptr = &pool;					/* the eventfd */
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, pool.eventFd, &event);
+
+	/* The workers block the stop signals, so they interrupt the main thread. */
+	sigemptyset(&stopSignals);
+	sigaddset(&stopSignals, SIGINT);
+	sigaddset(&stopSignals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &stopSignals, NULL);
+	for (i = 0; i < nThreads; i++)
+	{
+		if (pthread_create(&threads[i], NULL, worker, NULL) != 0)
+		{
+			printError("Error: Cannot start worker threads.\n");
+			nThreads = i;
+			stopRequested = 1;
+			break;
+		}
+	}
+	pthread_sigmask(SIG_UNBLOCK, &stopSignals, NULL);
+
+	printDebug("Serving on %s with %ld workers\n", path, nThreads);
+
+	while (!stopRequested)
+	{
+		if ((n = epoll_wait(epollFd, events, MAX_EVENTS, -1)) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			printError("Error: epoll_wait failed: %s\n", strerror(errno));
+			break;
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			if (events[i].data.ptr == NULL)
+			{
+				while ((clientFd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK)) >= 0)
+				{
+					if ((c = calloc(1, sizeof(Connection))) == NULL)
+					{
+						fprintf(stderr, "Error: Not enough memory for a connection.\n");
+						close(clientFd);
+						continue;
+					}
+					c->fd = clientFd;
+					watch(epollFd, c, EPOLLIN);
+				}
+			}
+			else if (events[i].data.ptr == &pool)
+			{
+				while (read(pool.eventFd, &signals, sizeof(signals)) > 0)
+					;
+
+				pthread_mutex_lock(&pool.lock);
+				done = pool.done;
+				pool.done = NULL;
+				pthread_mutex_unlock(&pool.lock);
+
+				while ((c = done) != NULL)
+				{
+					done = c->next;
+					sendReply(epollFd, c);
+				}
+			}
+			else
+			{
+				c = events[i].data.ptr;
+				if (c->outLength > 0)		/* still sending a reply */
+					sendReply(epollFd, c);
+				else
+					readRequest(epollFd, c);
+			}
+		}
+	}
+
+	pthread_mutex_lock(&pool.lock);
+	pool.stopping = 1;
+	pthread_cond_broadcast(&pool.ready);
+	pthread_mutex_unlock(&pool.lock);
+	for (i = 0; i < nThreads; i++)
+		pthread_join(threads[i], NULL);
+
+	close(listenFd);
+	close(epollFd);
+	close(pool.eventFd);
+	unlink(path);
+	return 0;
+}
+
+static int listenAt(const char * path)
+{
+	struct sockaddr_un address;
+	int fd;
+
+	if (strlen(path) >= sizeof(address.sun_path))
+	{
+		printError("Error: Socket path %s is too long.\n", path);
+		return -1;
+	}
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+	unlink(path);
+
+	if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0)) < 0
+		|| bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0
+		|| listen(fd, SOMAXCONN) != 0)
+	{
+		printError("Error: Cannot listen on %s: %s\n", path, strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static void onSignal(int signalNumber)
+{
+	(void)signalNumber;
+	stopRequested = 1;
+}
+
+static void * worker(void * arg)
+{
+	Connection * c;
+	uint64_t one = 1;
+
+	(void)arg;
+	for (;;)
+	{
+		pthread_mutex_lock(&pool.lock);
+		while (pool.jobs == NULL && !pool.stopping)
+			pthread_cond_wait(&pool.ready, &pool.lock);
+		if (pool.jobs == NULL)
+		{
+			pthread_mutex_unlock(&pool.lock);
+			return NULL;
+		}
+		c = pool.jobs;
+		if ((pool.jobs = c->next) == NULL)
+			pool.lastJob = &pool.jobs;
+		pthread_mutex_unlock(&pool.lock);
+
+		answer(c);
+
+		pthread_mutex_lock(&pool.lock);
+		c->next = pool.done;
+		pool.done = c;
+		pthread_mutex_unlock(&pool.lock);
+		if (write(pool.eventFd, &one, sizeof(one)) < 0)
+			fprintf(stderr, "Error: Cannot wake the main thread.\n");
+	}
+}
+
+/* Formats the request at the front of c->in into c->out.  If there is
+ * no memory for the reply, the reply is an error message, or if there is
+ * not even room for that, empty, and the connection is closed once it is
+ * sent.
+ */
+static void answer(Connection * c)
+{
+	static const char noMemory[] = "Error: Not enough memory for the reply";
+	static const char invalidLine[] = "Error: Invalid line";
+	FrameHeader request;
+	const unsigned char * payload = c->in + SERVE_HEADER;
+	const unsigned char * line;
+	const unsigned char * end;
+	const unsigned char * newline;
+	unsigned char * record;
+	unsigned int word;
+	size_t count;
+	size_t i;
+	int length;
+	int valid;
+
+	decodeHeader(c->in, &request);
+	end = payload + request.length;
+	if (!reserve(c, SERVE_HEADER + 64))
+	{
+		c->outLength = 0;
+		c->closed = 1;
+		return;
+	}
+	c->outLength = SERVE_HEADER;
+
+	if ((request.kind != 'W' && request.kind != 'L')
+		|| (request.reply != 'T' && request.reply != 'B')
+		|| (request.kind == 'W' && request.length % 4 != 0))
+	{
+		length = sprintf((char *)c->out + SERVE_HEADER, "Error: Bad request");
+		encodeHeader(c->out, (unsigned int)length, 1, 0);
+		c->outLength += (size_t)length;
+		return;
+	}
+
+	/* One text line or record per word or line of the request. */
+	count = request.kind == 'W' ? request.length / 4 : request.length / 33 + 1;
+	if (!reserve(c, SERVE_HEADER + count * (request.reply == 'T' ? FORMAT_LIMIT + 1 : SERVE_RECORD)))
+	{
+		memcpy(c->out + SERVE_HEADER, noMemory, sizeof(noMemory) - 1);
+		encodeHeader(c->out, sizeof(noMemory) - 1, 1, 0);
+		c->outLength += sizeof(noMemory) - 1;
+		return;
+	}
+
+	for (i = 0, line = payload; line < end; i++)
+	{
+		if (request.kind == 'W')
+		{
+			word = ((unsigned int)line[0] << 24) | ((unsigned int)line[1] << 16)
+				| ((unsigned int)line[2] << 8) | line[3];
+			line += 4;
+			valid = 1;
+		}
+		else
+		{
+			if ((newline = memchr(line, '\n', (size_t)(end - line))) == NULL)
+				newline = end;
+			valid = newline - line == 32 && isBinaryLine(line);
+			word = valid ? packMIPSInstruction((char *)line) : 0;
+			line = newline + 1;
+			if (i >= count			/* lines shorter than 32 characters */
+				&& !reserve(c, c->outLength + 64 * (FORMAT_LIMIT + 1)))
+			{
+				memcpy(c->out + SERVE_HEADER, noMemory, sizeof(noMemory) - 1);
+				encodeHeader(c->out, sizeof(noMemory) - 1, 1, 0);
+				c->outLength = SERVE_HEADER + sizeof(noMemory) - 1;
+				return;
+			}
+		}
+
+		if (request.reply == 'T')
+		{
+			if (valid)
+			{
+				length = formatInstruction(word, (char *)c->out + c->outLength);
+				if (length < 0)
+					length = (int)strlen((char *)c->out + c->outLength);
+			}
+			else
+			{
+				length = sizeof(invalidLine) - 1;
+				memcpy(c->out + c->outLength, invalidLine, sizeof(invalidLine) - 1);
+			}
+			c->outLength += (size_t)length;
+			c->out[c->outLength++] = '\n';
+		}
+		else
+		{
+			const InstrInfo * instr = valid ? findInstruction(word) : NULL;
+
+			record = c->out + c->outLength;
+			record[0] = (unsigned char)(word >> 24);
+			record[1] = (unsigned char)(word >> 16);
+			record[2] = (unsigned char)(word >> 8);
+			record[3] = (unsigned char)word;
+			record[4] = (unsigned char)OPCODE(word);
+			record[5] = (unsigned char)RS(word);
+			record[6] = (unsigned char)RT(word);
+			record[7] = (unsigned char)RD(word);
+			record[8] = (unsigned char)SHAMT(word);
+			record[9] = (unsigned char)FUNCT(word);
+			record[10] = !valid ? SERVE_INVALID
+				: instr == NULL ? SERVE_UNKNOWN : (unsigned char)(instr - instructionTable);
+			record[11] = 0;
+			c->outLength += SERVE_RECORD;
+		}
+	}
+
+	encodeHeader(c->out, (unsigned int)(c->outLength - SERVE_HEADER), 0, 0);
+}
+
+/* Returns 1 if the 32 characters at line are all '0' or '1'. */
+static int isBinaryLine(const unsigned char * line)
+{
+	int k;
+
+	for (k = 0; k < 32; k++)
+	{
+		if (line[k] != '0' && line[k] != '1')
+			return 0;
+	}
+	return 1;
+}
+
+/* Makes room for length bytes of reply, keeping what is there.
+ * Returns: 1, or 0 if there is not enough memory (the reply is kept).
+ */
+static int reserve(Connection * c, size_t length)
+{
+	unsigned char * grown;
+	size_t capacity = length + length / 2;
+
+	if (length > c->outCapacity)
+	{
+		if ((grown = realloc(c->out, capacity)) == NULL)
+			return 0;
+		c->out = grown;
+		c->outCapacity = capacity;
+	}
+	return 1;
+}
+
+/* Reads what has arrived, but not past the end of the request at the
+ * front of c->in (a small request may be read along with READ_SIZE
+ * bytes of the ones after it), and starts the request once it is
+ * complete.  The header is checked as soon as it is in: a request over
+ * SERVE_MAX_FRAME bytes, or one there is no memory for, closes the
+ * connection.
+ */
+static void readRequest(int epollFd, Connection * c)
+{
+	FrameHeader request;
+	unsigned char * grown;
+	size_t end;				/* bytes up to the end of the request */
+	size_t limit;			/* bytes to read up to */
+	ssize_t got;
+
+	for (;;)
+	{
+		end = SERVE_HEADER;
+		if (c->inLength >= SERVE_HEADER)
+		{
+			decodeHeader(c->in, &request);
+			if (request.length > SERVE_MAX_FRAME)
+			{
+				closeConnection(epollFd, c);
+				return;
+			}
+			end += request.length;
+		}
+		if (c->inLength >= end)
+			break;
+
+		limit = end > READ_SIZE ? end : READ_SIZE;
+		if (c->inCapacity < limit)
+		{
+			if ((grown = realloc(c->in, limit)) == NULL)
+			{
+				fprintf(stderr, "Error: Not enough memory for a request of %zu bytes.\n", end);
+				closeConnection(epollFd, c);
+				return;
+			}
+			c->in = grown;
+			c->inCapacity = limit;
+		}
+
+		got = read(c->fd, c->in + c->inLength, limit - c->inLength);
+		if (got > 0)
+		{
+			c->inLength += (size_t)got;
+			continue;
+		}
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+			c->closed = 1;
+		break;
+	}
+
+	startNext(epollFd, c);
+}
+
+/* Hands the next complete request to a worker, or waits for more. */
+static void startNext(int epollFd, Connection * c)
+{
+	FrameHeader request;
+
+	if (c->inLength >= SERVE_HEADER)
+	{
+		decodeHeader(c->in, &request);
+		if (request.length > SERVE_MAX_FRAME)
+		{
+			closeConnection(epollFd, c);
+			return;
+		}
+
+		if (c->inLength >= SERVE_HEADER + request.length)
+		{
+			watch(epollFd, c, 0);
+			c->next = NULL;
+
+			pthread_mutex_lock(&pool.lock);
+			*pool.lastJob = c;
+			pool.lastJob = &c->next;
+			pthread_cond_signal(&pool.ready);
+			pthread_mutex_unlock(&pool.lock);
+			return;
+		}
+	}
+
+	if (c->closed)
+		closeConnection(epollFd, c);
+	else
+		watch(epollFd, c, EPOLLIN);
+}
+
+/* Sends as much of the reply as the socket takes. */
+static void sendReply(int epollFd, Connection * c)
+{
+	FrameHeader request;
+	ssize_t sent;
+
+	if (c->outLength == 0)			/* no memory even for an error message */
+	{
+		closeConnection(epollFd, c);
+		return;
+	}
+
+	while (c->outSent < c->outLength)
+	{
+		sent = write(c->fd, c->out + c->outSent, c->outLength - c->outSent);
+		if (sent > 0)
+		{
+			c->outSent += (size_t)sent;
+			continue;
+		}
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			watch(epollFd, c, EPOLLOUT);
+			return;
+		}
+		closeConnection(epollFd, c);
+		return;
+	}
+
+	/* Drop the answered request; later ones move to the front. */
+	decodeHeader(c->in, &request);
+	c->inLength -= SERVE_HEADER + request.length;
+	memmove(c->in, c->in + SERVE_HEADER + request.length, c->inLength);
+	c->outLength = 0;
+	c->outSent = 0;
+
+	startNext(epollFd, c);
+}
+
+/* Watches c for events, or (if events is 0) stops watching it; a
+ * connection a worker has is not watched at all, so a hang-up cannot be reported
+ * while a worker is using it.
+ */
+static void watch(int epollFd, Connection * c, unsigned int events)
+{
+	struct epoll_event event;
+
+	event.events = events;
+	event.data.ptr = c;
+
+	if (events == 0)
+	{
+		if (c->watched)
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, NULL);
+		c->watched = 0;
+	}
+	else
+	{
+		epoll_ctl(epollFd, c->watched ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, c->fd, &event);
+		c->watched = 1;
+	}
+}
+
+static void closeConnection(int epollFd, Connection * c)
+{
+	watch(epollFd, c, 0);
+	close(c->fd);
+	free(c->in);
+	free(c->out);
+	free(c);
+}
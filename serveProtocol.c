@@ -0,0 +1,174 @@
+/*
+ * serveProtocol
+ *
+ * These functions build and read the frames exchanged with the --serve
+ * daemon (the format is described in serveProtocol.h).  The daemon
+ * uses the header functions; the client and the benchmark also use the
+ * blocking send and receive functions.
+ *
+ * void encodeHeader(unsigned char header[], unsigned int length,
+ *                   unsigned char kind, unsigned char reply)
+ * void decodeHeader(const unsigned char header[], FrameHeader * frame)
+ *   Convert between a header's 8 bytes and its fields.
+ *
+ * int connectToServer(const char * path)
+ *   Returns: a socket connected to the daemon listening at path, or -1
+ *            (after printing an error message).
+ *
+ * int sendFrame(int fd, unsigned char kind, unsigned char reply,
+ *               const unsigned char * payload, unsigned int length)
+ *   Sends one request.  Returns: 1, or 0 if the connection failed.
+ *
+ * int receiveFrame(int fd, FrameHeader * frame, unsigned char ** payload,
+ *                  size_t * capacity)
+ *   Receives one reply into *payload, which is grown (and *capacity
+ *   updated) when needed, so a caller can reuse one buffer for every
+ *   reply.  Returns: 1, 0 if the connection failed or closed, or -1 if
+ *   there was not enough memory for the reply (after printing an error
+ *   message).  The caller closes the connection either way.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include "printFuncs.h"
+#include "serveProtocol.h"
+
+static int readAll(int fd, unsigned char * data, size_t length);
+
+void encodeHeader(unsigned char header[SERVE_HEADER], unsigned int length,
+				  unsigned char kind, unsigned char reply)
+{
+	header[0] = (unsigned char)(length >> 24);
+	header[1] = (unsigned char)(length >> 16);
+	header[2] = (unsigned char)(length >> 8);
+	header[3] = (unsigned char)length;
+	header[4] = kind;
+	header[5] = reply;
+	header[6] = 0;
+	header[7] = 0;
+}
+
+void decodeHeader(const unsigned char header[SERVE_HEADER], FrameHeader * frame)
+{
+	frame->length = ((unsigned int)header[0] << 24) | ((unsigned int)header[1] << 16)
+		| ((unsigned int)header[2] << 8) | header[3];
+	frame->kind = header[4];
+	frame->reply = header[5];
+}
+
+int connectToServer(const char * path)
+{
+	struct sockaddr_un address;
+	int fd;
+
+	if (strlen(path) >= sizeof(address.sun_path))
+	{
+		printError("Error: Socket path %s is too long.\n", path);
+		return -1;
+	}
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+
+	if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0
+		|| connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+	{
+		printError("Error: Cannot connect to %s: %s\n", path, strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+int sendFrame(int fd, unsigned char kind, unsigned char reply,
+			  const unsigned char * payload, unsigned int length)
+{
+	unsigned char header[SERVE_HEADER];
+	struct iovec parts[2];
+	ssize_t sent;
+	int first = 0;
+
+	encodeHeader(header, length, kind, reply);
+	parts[0].iov_base = header;
+	parts[0].iov_len = SERVE_HEADER;
+	parts[1].iov_base = (void *)payload;
+	parts[1].iov_len = length;
+
+	/* One system call for the header and payload in the usual case. */
+	while (first < 2)
+	{
+		sent = writev(fd, parts + first, 2 - first);
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent <= 0)
+			return 0;
+
+		while (first < 2 && (size_t)sent >= parts[first].iov_len)
+		{
+			sent -= (ssize_t)parts[first].iov_len;
+			first++;
+		}
+		if (first < 2)
+		{
+			parts[first].iov_base = (char *)parts[first].iov_base + sent;
+			parts[first].iov_len -= (size_t)sent;
+		}
+	}
+
+	return 1;
+}
+
+int receiveFrame(int fd, FrameHeader * frame, unsigned char ** payload, size_t * capacity)
+{
+	unsigned char header[SERVE_HEADER];
+	unsigned char * larger;
+
+	if (!readAll(fd, header, SERVE_HEADER))
+		return 0;
+	decodeHeader(header, frame);
+
+	if ((size_t)frame->length + 1 > *capacity)
+	{
+		if ((larger = realloc(*payload, (size_t)frame->length + 1)) == NULL)
+		{
+			printError("Error: Not enough memory for a reply of %u bytes.\n", frame->length);
+			return -1;
+		}
+		*payload = larger;
+		*capacity = (size_t)frame->length + 1;
+	}
+
+	if (!readAll(fd, *payload, frame->length))
+		return 0;
+	(*payload)[frame->length] = '\0';	/* so a text reply is a string */
+	return 1;
+}
+
+static int readAll(int fd, unsigned char * data, size_t length)
+{
+	ssize_t got;
+
+	while (length > 0)
+	{
+		got = read(fd, data, length);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got <= 0)
+			return 0;
+		data += got;
+		length -= (size_t)got;
+	}
+
+	return 1;
+}
@@ -0,0 +1,60 @@
+/*
+ * This file describes the framing used between the --serve daemon and
+ * its clients (see serve.c, disclient.c and disbench.c) and provides
+ * the signatures of the shared framing functions (see serveProtocol.c).
+ *
+ * Every request and every reply is a frame: an 8 byte header followed
+ * by length bytes of payload.
+ *
+ *      Request header:  length(4, big-endian) kind(1) reply(1) 0(2)
+ *          kind  'W'  the payload is instruction words, 4 bytes each,
+ *                     most significant byte first
+ *                'L'  the payload is lines of 32 '0'/'1' characters,
+ *                     each ended by a newline
+ *          reply 'T'  reply with text, one line per instruction
+ *                'B'  reply with SERVE_RECORD byte records
+ *
+ *      Reply header:    length(4, big-endian) status(1) 0(3)
+ *          status 0   ok: one line or record per instruction, in order
+ *                 1   bad request: the payload is an error message
+ *
+ * A binary record is
+ *      word(4, big-endian) opcode rs rt rd shamt funct index 0
+ * where index is the instruction's position in instructionTable, or
+ * SERVE_UNKNOWN if the word is not an instruction, or SERVE_INVALID if
+ * the request line was not 32 '0'/'1' characters (the other fields are
+ * then 0).  In a text reply those cases give the formatter's error
+ * message, or "Error: Invalid line".
+ *
+ * A connection may send any number of requests; replies come back in
+ * the same order.
+ */
+
+#ifndef _SERVE_PROTOCOL_H
+#define _SERVE_PROTOCOL_H
+
+#include <stddef.h>
+
+#define SERVE_HEADER	8
+#define SERVE_RECORD	12
+#define SERVE_MAX_FRAME	(64 << 20)	/* largest payload accepted */
+
+#define SERVE_UNKNOWN	0xFF
+#define SERVE_INVALID	0xFE
+
+typedef struct
+{
+	unsigned int length;
+	unsigned char kind;		/* request: 'W' or 'L'; reply: status */
+	unsigned char reply;	/* request only: 'T' or 'B' */
+} FrameHeader;
+
+void encodeHeader(unsigned char header[SERVE_HEADER], unsigned int length,
+				  unsigned char kind, unsigned char reply);
+void decodeHeader(const unsigned char header[SERVE_HEADER], FrameHeader * frame);
+int connectToServer(const char * path);
+int sendFrame(int fd, unsigned char kind, unsigned char reply,
+			  const unsigned char * payload, unsigned int length);
+int receiveFrame(int fd, FrameHeader * frame, unsigned char ** payload, size_t * capacity);
+
+#endif
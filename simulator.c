@@ -0,0 +1,564 @@
+/*
+ * simulator
+ *
+ * This file implements the --simulate option: instead of printing the
+ * instructions, the program is run from the first line, as if it had
+ * been loaded at the text base address (--base, 0x00400000 by default).
+ *
+ * int simulateProgram(LineReader * reader)
+ *   Reads the whole program, runs it until it stops, and prints the
+ *   reason it stopped, the number of instructions executed and the
+ *   final register values.
+ *   Returns: the exit status for main (0 if the program exited normally).
+ *
+ * The machine has the 32 general registers, HI and LO, a program
+ * counter and a sparse 32-bit memory.  Only the instructions in the
+ * instruction table are supported (none of them use HI and LO, but they
+ * are part of the machine state and are printed at the end).  As on
+ * the real machine, branches and jumps have a delay slot: the
+ * instruction after one runs before it takes effect, and jal sets $ra to
+ * its own address + 8, past the slot.  A branch or jump in a delay slot
+ * is a fault.  Instructions that write $zero still fault as they would
+ * (an addi that overflows, an unaligned lw), but the write is dropped.
+ * Initially $sp = 0x7fffeffc, $gp = 0x10008000 and $ra = 0, so a final
+ * "jr $ra" ends the program.  The program stops when:
+ *      - the program counter leaves the text segment (normal exit),
+ *      - an instruction faults (add/addi/sub overflow, an unaligned
+ *        address, an instruction not in the table),
+ *      - --max-steps instructions have run (checked between blocks), or
+ *      - there is no memory for a page or a translated block; then only
+ *        an error is printed.
+ *
+ * Implementation:
+ *      Memory is a two level page table of 4 KB pages, allocated the
+ *      first time a page is written; reads of unwritten memory give 0.
+ *      The program's words are copied into memory at the text base.
+ *
+ *      Each instruction is decoded only once, when the basic block that
+ *      contains it is first reached.  Decoding turns it into an Op: a
+ *      pointer to the handler function for that instruction plus its
+ *      register numbers and a pre-extended immediate (branch and jump
+ *      targets are already absolute addresses).  Running a block is
+ *      just calling the handlers one after another until one of them
+ *      ends the block.  Translated blocks are kept in a hash table keyed
+ *      by their start address.  A store into the text segment empties
+ *      the table so that changed instructions are decoded again.
+ *
+ *      A block ends with a branch or jump and its delay slot.  The
+ *      branch's handler sets the program counter but lets the block go
+ *      on, so the slot's handler runs next, and a final handler ends the
+ *      block.  Writes to $zero go to a 33rd register that nothing reads,
+ *      so no handler has to check for $zero.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <time.h>
+
+#include "disassembler.h"
+
+#define PAGE_BITS     12
+#define PAGE_MASK     ((1U << PAGE_BITS) - 1)
+#define TABLE_BITS    10
+#define DIR_BITS      (32 - PAGE_BITS - TABLE_BITS)
+#define MAX_BLOCK     64		/* instructions per translated block */
+#define SINK          32		/* register that takes writes to $zero */
+#define BUCKETS       65536		/* hash table size for translated blocks */
+#define LOAD_CHUNK    65536
+
+/* What a handler returns. */
+enum { OP_NEXT, OP_END, OP_FAULT, OP_FLUSH, OP_NOMEM };
+
+typedef struct
+{
+	unsigned int regs[33];	/* regs[SINK] takes writes to $zero */
+	unsigned int hi;
+	unsigned int lo;
+	unsigned int pc;
+	const char * fault;		/* why the program stopped early, if it did */
+} Cpu;
+
+typedef struct Op Op;
+typedef int (*OpHandler)(Cpu * cpu, const Op * op);
+
+struct Op
+{
+	OpHandler handler;
+	unsigned char rd;		/* destination (rt for I format) */
+	unsigned char rs;
+	unsigned char rt;
+	unsigned int  imm;		/* extended immediate, shift amount or target */
+	unsigned int  next;		/* address of the following instruction */
+};
+
+typedef struct Block
+{
+	struct Block * chain;	/* next block in the same hash bucket */
+	unsigned int start;
+	int length;				/* real instructions in ops */
+	int slot;				/* 1 if the last of them is a delay slot */
+	Op ops[MAX_BLOCK + 2];	/* + a delay slot and a terminator */
+} Block;
+
+typedef struct
+{
+	unsigned int * pages[1 << TABLE_BITS];
+} PageTable;
+
+static PageTable * directory[1 << DIR_BITS];
+static Block * blocks[BUCKETS];
+static unsigned int textStart;
+static unsigned int textEnd;
+
+/* ---------- memory ---------- */
+
+/* Returns NULL if the page is not there, or cannot be created. */
+static unsigned int * findPage(unsigned int address, int create)
+{
+	PageTable ** table = &directory[address >> (32 - DIR_BITS)];
+	unsigned int ** page;
+
+	if (*table == NULL)
+	{
+		if (!create)
+			return NULL;
+		if ((*table = calloc(1, sizeof(PageTable))) == NULL)
+			return NULL;
+	}
+
+	page = &(*table)->pages[(address >> PAGE_BITS) & ((1 << TABLE_BITS) - 1)];
+	if (*page == NULL && create)
+	{
+		*page = calloc(1, 1 << PAGE_BITS);
+	}
+
+	return *page;
+}
+
+static unsigned int readMemory(unsigned int address)
+{
+	unsigned int * page = findPage(address, 0);
+
+	return page ? page[(address & PAGE_MASK) >> 2] : 0;
+}
+
+/* Returns 0, or -1 if there is no memory for the page. */
+static int writeMemory(unsigned int address, unsigned int word)
+{
+	unsigned int * page = findPage(address, 1);
+
+	if (page == NULL)
+		return -1;
+	page[(address & PAGE_MASK) >> 2] = word;
+	return 0;
+}
+
+static void freeMemory(void)
+{
+	int i, j;
+
+	for (i = 0; i < (1 << DIR_BITS); i++)
+	{
+		if (directory[i] == NULL)
+			continue;
+		for (j = 0; j < (1 << TABLE_BITS); j++)
+			free(directory[i]->pages[j]);
+		free(directory[i]);
+		directory[i] = NULL;
+	}
+}
+
+/* ---------- instruction handlers ---------- */
+
+static int fault(Cpu * cpu, const Op * op, const char * reason)
+{
+	cpu->pc = op->next - 4;
+	cpu->fault = reason;
+	return OP_FAULT;
+}
+
+#define OVERFLOWS(a, b, r)	((~((a) ^ (b)) & ((a) ^ (r))) >> 31)
+
+static int opAdd(Cpu * cpu, const Op * op)
+{
+	unsigned int a = cpu->regs[op->rs], b = cpu->regs[op->rt], r = a + b;
+	if (OVERFLOWS(a, b, r))
+		return fault(cpu, op, "arithmetic overflow");
+	cpu->regs[op->rd] = r;
+	return OP_NEXT;
+}
+
+static int opSub(Cpu * cpu, const Op * op)
+{
+	unsigned int a = cpu->regs[op->rs], b = cpu->regs[op->rt], r = a - b;
+	if (((a ^ b) & (a ^ r)) >> 31)
+		return fault(cpu, op, "arithmetic overflow");
+	cpu->regs[op->rd] = r;
+	return OP_NEXT;
+}
+
+static int opAddi(Cpu * cpu, const Op * op)
+{
+	unsigned int a = cpu->regs[op->rs], r = a + op->imm;
+	if (OVERFLOWS(a, op->imm, r))
+		return fault(cpu, op, "arithmetic overflow");
+	cpu->regs[op->rd] = r;
+	return OP_NEXT;
+}
+
+static int opAddu(Cpu * c, const Op * o)  { c->regs[o->rd] = c->regs[o->rs] + c->regs[o->rt]; return OP_NEXT; }
+static int opSubu(Cpu * c, const Op * o)  { c->regs[o->rd] = c->regs[o->rs] - c->regs[o->rt]; return OP_NEXT; }
+static int opAnd(Cpu * c, const Op * o)   { c->regs[o->rd] = c->regs[o->rs] & c->regs[o->rt]; return OP_NEXT; }
+static int opOr(Cpu * c, const Op * o)    { c->regs[o->rd] = c->regs[o->rs] | c->regs[o->rt]; return OP_NEXT; }
+static int opNor(Cpu * c, const Op * o)   { c->regs[o->rd] = ~(c->regs[o->rs] | c->regs[o->rt]); return OP_NEXT; }
+static int opSlt(Cpu * c, const Op * o)   { c->regs[o->rd] = (int)c->regs[o->rs] < (int)c->regs[o->rt]; return OP_NEXT; }
+static int opSltu(Cpu * c, const Op * o)  { c->regs[o->rd] = c->regs[o->rs] < c->regs[o->rt]; return OP_NEXT; }
+static int opSll(Cpu * c, const Op * o)   { c->regs[o->rd] = c->regs[o->rt] << o->imm; return OP_NEXT; }
+static int opSrl(Cpu * c, const Op * o)   { c->regs[o->rd] = c->regs[o->rt] >> o->imm; return OP_NEXT; }
+static int opAddiu(Cpu * c, const Op * o) { c->regs[o->rd] = c->regs[o->rs] + o->imm; return OP_NEXT; }
+static int opSlti(Cpu * c, const Op * o)  { c->regs[o->rd] = (int)c->regs[o->rs] < (int)o->imm; return OP_NEXT; }
+static int opSltiu(Cpu * c, const Op * o) { c->regs[o->rd] = c->regs[o->rs] < o->imm; return OP_NEXT; }
+static int opAndi(Cpu * c, const Op * o)  { c->regs[o->rd] = c->regs[o->rs] & o->imm; return OP_NEXT; }
+static int opOri(Cpu * c, const Op * o)   { c->regs[o->rd] = c->regs[o->rs] | o->imm; return OP_NEXT; }
+static int opLui(Cpu * c, const Op * o)   { c->regs[o->rd] = o->imm; return OP_NEXT; }
+
+static int opLw(Cpu * cpu, const Op * op)
+{
+	unsigned int address = cpu->regs[op->rs] + op->imm;
+	if (address & 3)
+		return fault(cpu, op, "unaligned load address");
+	cpu->regs[op->rd] = readMemory(address);
+	return OP_NEXT;
+}
+
+static int opSw(Cpu * cpu, const Op * op)
+{
+	unsigned int address = cpu->regs[op->rs] + op->imm;
+	if (address & 3)
+		return fault(cpu, op, "unaligned store address");
+	if (writeMemory(address, cpu->regs[op->rt]) != 0)
+		return OP_NOMEM;
+	if (address >= textStart && address < textEnd)
+		return OP_FLUSH;		/* the program changed its own code */
+	return OP_NEXT;
+}
+
+/* Branches and jumps set the program counter and go on to the delay
+ * slot; o->next + 4 is the instruction after the slot.
+ */
+static int opBeq(Cpu * c, const Op * o)
+{
+	c->pc = (c->regs[o->rs] == c->regs[o->rt]) ? o->imm : o->next + 4;
+	return OP_NEXT;
+}
+
+static int opBne(Cpu * c, const Op * o)
+{
+	c->pc = (c->regs[o->rs] != c->regs[o->rt]) ? o->imm : o->next + 4;
+	return OP_NEXT;
+}
+
+static int opJ(Cpu * c, const Op * o)     { c->pc = o->imm; return OP_NEXT; }
+static int opJal(Cpu * c, const Op * o)   { c->regs[31] = o->next + 4; c->pc = o->imm; return OP_NEXT; }
+static int opJr(Cpu * c, const Op * o)    { c->pc = c->regs[o->rs]; return OP_NEXT; }
+static int opFallThrough(Cpu * c, const Op * o) { c->pc = o->next; return OP_END; }
+static int opEndSlot(Cpu * c, const Op * o) { (void)c; (void)o; return OP_END; }
+
+static int opBranchInSlot(Cpu * cpu, const Op * op)
+{
+	return fault(cpu, op, "branch or jump in a delay slot");
+}
+
+static int opIllegal(Cpu * cpu, const Op * op)
+{
+	return fault(cpu, op, "instruction not in the instruction table");
+}
+
+/* ---------- translation ---------- */
+
+/* The handler for each mnemonic in the instruction table. */
+static const struct
+{
+	const char * name;
+	OpHandler handler;
+} handlers[] = {
+	{ "sll", opSll },   { "srl", opSrl },     { "jr", opJr },
+	{ "add", opAdd },   { "addu", opAddu },   { "sub", opSub },
+	{ "subu", opSubu }, { "and", opAnd },     { "or", opOr },
+	{ "nor", opNor },   { "slt", opSlt },     { "sltu", opSltu },
+	{ "beq", opBeq },   { "bne", opBne },     { "addi", opAddi },
+	{ "addiu", opAddiu }, { "slti", opSlti }, { "sltiu", opSltiu },
+	{ "andi", opAndi }, { "ori", opOri },     { "lui", opLui },
+	{ "lw", opLw },     { "sw", opSw },       { "j", opJ },
+	{ "jal", opJal }
+};
+
+static OpHandler handlerFor(const InstrInfo * instr)
+{
+	int i;
+
+	for (i = 0; i < (int)(sizeof(handlers) / sizeof(handlers[0])); i++)
+	{
+		if (strcmp(handlers[i].name, instr->name) == SAME)
+			return handlers[i].handler;
+	}
+	return opIllegal;
+}
+
+/* Decodes one instruction; returns 1 if it ends a basic block. */
+static int decodeOp(unsigned int word, unsigned int pc, Op * op)
+{
+	const InstrInfo * instr = findInstruction(word);
+	unsigned int simm = (unsigned int)(int)(short)IMM(word);	/* sign extended */
+
+	op->next = pc + 4;
+	op->rs = RS(word);
+	op->rt = RT(word);
+	op->rd = RD(word);
+	op->imm = simm;
+
+	if (instr == NULL)
+	{
+		op->handler = opIllegal;
+		return 1;
+	}
+	op->handler = handlerFor(instr);
+
+	switch (instr->layout)
+	{
+		case LAYOUT_SHIFT :
+			op->imm = SHAMT(word);
+		break;
+
+		case LAYOUT_ARITH :
+		case LAYOUT_MEM :
+			op->rd = RT(word);
+			if (instr->opcode == 12 || instr->opcode == 13)	/* andi, ori */
+				op->imm = IMM(word);
+		break;
+
+		case LAYOUT_LUI :
+			op->rd = RT(word);
+			op->imm = IMM(word) << 16;
+		break;
+
+		case LAYOUT_BRANCH :
+			op->imm = pc + 4 + (simm << 2);
+			return 1;
+
+		case LAYOUT_JUMP :
+			op->imm = ((pc + 4) & 0xF0000000) | (TARGET(word) << 2);
+			return 1;
+
+		case LAYOUT_JR :
+			return 1;
+	}
+
+	/* Writes to $zero are thrown away (sw writes no register). */
+	if (op->rd == 0)
+		op->rd = SINK;
+
+	return 0;
+}
+
+/* Returns NULL if there is no memory for the block. */
+static Block * translateBlock(unsigned int start)
+{
+	Block * block = malloc(sizeof(Block));
+	unsigned int pc = start;
+	int ends = 0;
+
+	if (block == NULL)
+		return NULL;
+	block->start = start;
+	block->length = 0;
+	block->slot = 0;
+
+	while (!ends && block->length < MAX_BLOCK && pc < textEnd)
+	{
+		ends = decodeOp(readMemory(pc), pc, &block->ops[block->length]);
+		block->length++;
+		pc += 4;
+	}
+
+	/* A branch or jump (not an illegal instruction) takes its delay slot
+	 * into the block.
+	 */
+	if (ends && block->ops[block->length - 1].handler != opIllegal)
+	{
+		if (decodeOp(readMemory(pc), pc, &block->ops[block->length])
+			&& block->ops[block->length].handler != opIllegal)
+			block->ops[block->length].handler = opBranchInSlot;
+		block->length++;
+		block->slot = 1;
+		block->ops[block->length].handler = opEndSlot;
+	}
+	else if (!ends)
+	{
+		block->ops[block->length].handler = opFallThrough;
+		block->ops[block->length].next = pc;
+	}
+
+	return block;
+}
+
+static Block * findBlock(unsigned int pc)
+{
+	Block ** bucket = &blocks[(pc >> 2) & (BUCKETS - 1)];
+	Block * block;
+
+	for (block = *bucket; block != NULL; block = block->chain)
+	{
+		if (block->start == pc)
+			return block;
+	}
+
+	if ((block = translateBlock(pc)) == NULL)
+		return NULL;
+	block->chain = *bucket;
+	*bucket = block;
+	return block;
+}
+
+static void flushBlocks(void)
+{
+	Block * block;
+	Block * next;
+	int i;
+
+	for (i = 0; i < BUCKETS; i++)
+	{
+		for (block = blocks[i]; block != NULL; block = next)
+		{
+			next = block->chain;
+			free(block);
+		}
+		blocks[i] = NULL;
+	}
+}
+
+/* ---------- driver ---------- */
+
+static void printState(const Cpu * cpu)
+{
+	int i;
+
+	printf("pc    = 0x%08x\n", cpu->pc);
+	for (i = 0; i < 32; i++)
+	{
+		printf("%-5s = 0x%08x%s", getRegName(i), cpu->regs[i], (i % 4 == 3) ? "\n" : "   ");
+	}
+	printf("hi    = 0x%08x   lo    = 0x%08x\n", cpu->hi, cpu->lo);
+}
+
+int simulateProgram(LineReader * reader)
+{
+	static unsigned int words[LOAD_CHUNK];
+	static int lineNums[LOAD_CHUNK];
+	static Cpu cpu;
+	unsigned long steps = 0;
+	int   lineNum = 0;
+	int   loaded = 0;
+	int   count;
+	int   i;
+	int   status = OP_END;
+	const Op * op;
+	Block * block;
+	clock_t startTime;
+
+	textStart = (unsigned int)options.textBase;
+	textEnd = textStart;
+
+	while ((count = readWordBlock(reader, words, lineNums, LOAD_CHUNK, &lineNum)) > 0)
+	{
+		for (i = 0; i < count; i++)
+		{
+			if (writeMemory(textEnd, words[i]) != 0)
+			{
+				printError("Error: Not enough memory for the simulation.\n");
+				freeMemory();
+				return 1;
+			}
+			textEnd += 4;
+		}
+		loaded += count;
+	}
+
+	if (loaded == 0 || loaded != lineNum)
+	{
+		printError("Error: Cannot simulate; the program has %s.\n",
+				   loaded == 0 ? "no instructions" : "invalid lines");
+		freeMemory();
+		return 1;
+	}
+
+	memset(&cpu, 0, sizeof(cpu));
+	cpu.regs[28] = 0x10008000;		/* $gp */
+	cpu.regs[29] = 0x7FFFEFFC;		/* $sp */
+	cpu.pc = textStart;
+
+	startTime = clock();
+	while (steps < options.maxSteps)
+	{
+		if (cpu.pc & 3)
+		{
+			cpu.fault = "unaligned program counter";
+			break;
+		}
+		if (cpu.pc < textStart || cpu.pc >= textEnd)
+			break;
+
+		if ((block = findBlock(cpu.pc)) == NULL)
+		{
+			status = OP_NOMEM;
+			break;
+		}
+		for (op = block->ops; (status = op->handler(&cpu, op)) == OP_NEXT; op++)
+			;
+
+		if (status == OP_NOMEM)
+			break;
+		if (status == OP_FAULT)
+		{
+			steps += op - block->ops;
+			break;
+		}
+		steps += (op - block->ops) + (op < block->ops + block->length);
+
+		if (status == OP_FLUSH)
+		{
+			/* After a store in a delay slot, the branch says where to go. */
+			if (!(block->slot && op == block->ops + block->length - 1))
+				cpu.pc = op->next;
+			flushBlocks();
+		}
+	}
+
+	if (status == OP_NOMEM)
+	{
+		printError("Error: Not enough memory for the simulation.\n");
+		flushBlocks();
+		freeMemory();
+		return 1;
+	}
+
+	printDebug("Simulated %lu instructions in %.3f seconds\n", steps,
+			   (double)(clock() - startTime) / CLOCKS_PER_SEC);
+
+	if (cpu.fault != NULL && cpu.pc >= textStart && cpu.pc < textEnd)
+		printf("Simulation stopped: %s at 0x%08x (line %u)\n", cpu.fault, cpu.pc,
+			   (cpu.pc - textStart) / 4 + 1);
+	else if (cpu.fault != NULL)
+		printf("Simulation stopped: %s at 0x%08x\n", cpu.fault, cpu.pc);
+	else if (steps >= options.maxSteps)
+		printf("Simulation stopped: step limit reached at 0x%08x\n", cpu.pc);
+	else
+		printf("Simulation exited to 0x%08x\n", cpu.pc);
+
+	printf("Instructions executed: %lu\n", steps);
+	printState(&cpu);
+
+	flushBlocks();
+	freeMemory();
+	return cpu.fault != NULL ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * sniffInput
+ *
+ * This function works out what kind of input the disassembler has been
+ * given from its first few KB, so the right reader can be used without
+ * the operator having to say (see openInput in wordReader.c).
+ *
+ * const char * sniffInput(const unsigned char * data, size_t length,
+ *                         int * bigEndian)
+ *   Pre-condition:  data holds the first length bytes of the input,
+ *                   after any decompression (see decompressInput.c)
+ *   Returns: the --input format the data looks like:
+ *      "elf"   it starts with the ELF magic bytes
+ *      "raw"   it is not text; *bigEndian is set to the byte order under
+ *              which more of its words are MIPS instructions
+ *      "ihex"  the first line is an Intel HEX record
+ *      "srec"  the first line is an S-record
+ *      "memb"  binary digits with @ directives, comments or '_'
+ *      "memh"  hex digits with @ directives, comments or '_'
+ *      "hex"   hex words, one or more to a line, perhaps with 0x; every
+ *              line looked at must be such words, of at most 8 digits
+ *      "bin"   anything else: lines of 32 '0's and '1's, or input the
+ *              main loop should report line by line
+ *   Text that could be more than one of these is taken to be "bin", so
+ *   input that was read as binary lines before still is.
+ *
+ * Implementation:
+ *      The first SNIFF_SIZE bytes are copied into a zero-padded buffer of
+ *      fixed size, and the character classes are counted in one pass
+ *      with a branch-free compare per class.  The loop has a fixed trip
+ *      count and no stores, so the compiler turns it into vector
+ *      compares and adds, 16 or 32 bytes at a time.  Only the decisions
+ *      that need the order of the bytes (the first line, decoding words
+ *      for the byte order, and parsing the lines as hex words) look at
+ *      the data again.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include "disassembler.h"
+
+#define SNIFF_SIZE	4096		/* bytes looked at */
+
+typedef struct
+{
+	unsigned int binary;		/* '0' and '1' */
+	unsigned int decimal;		/* '0' to '9' */
+	unsigned int hexLetter;		/* 'a' to 'f', either case */
+	unsigned int x;				/* 'x' or 'X', as in 0x */
+	unsigned int space;			/* ' ', '\t' and '\r' */
+	unsigned int newline;
+	unsigned int directive;		/* '@', '/' and '_' */
+	unsigned int control;		/* other bytes below ' ', and 0x7f up */
+} CharClasses;
+
+static void countClasses(const unsigned char sample[SNIFF_SIZE], CharClasses * counts);
+static int instructionScore(const unsigned char * data, size_t length, int bigEndian);
+static int isHexWords(const unsigned char * data, size_t length, int whole);
+
+const char * sniffInput(const unsigned char * data, size_t length, int * bigEndian)
+{
+	static unsigned char sample[SNIFF_SIZE] __attribute__((aligned(64)));
+	CharClasses c;
+	unsigned int text, hexChars, otherHex;
+	int whole = length < SNIFF_SIZE;	/* 1 if the last line is complete */
+	size_t i;
+
+	if (length >= 4 && memcmp(data, "\177ELF", 4) == SAME)
+		return "elf";
+
+	if (length > SNIFF_SIZE)
+		length = SNIFF_SIZE;
+	memset(sample, 0, SNIFF_SIZE);
+	memcpy(sample, data, length);
+	countClasses(sample, &c);
+	c.control -= (unsigned int)(SNIFF_SIZE - length);		/* the padding */
+
+	/* Text has next to no control bytes; raw words are full of them. */
+	if (c.control * 50 > length)
+	{
+		*bigEndian = instructionScore(data, length, 1) >= instructionScore(data, length, 0);
+		return "raw";
+	}
+
+	for (i = 0; i < length && isspace(data[i]); i++)
+		;
+	if (i + 1 < length && data[i] == ':' && isxdigit(data[i + 1]))
+		return "ihex";
+	if (i + 2 < length && data[i] == 'S' && isdigit(data[i + 1]) && isxdigit(data[i + 2]))
+		return "srec";
+
+	text = (unsigned int)length - c.space - c.newline;
+	hexChars = c.decimal + c.hexLetter + c.x + c.directive;
+	otherHex = c.decimal - c.binary + c.hexLetter;
+	if (text == 0 || hexChars * 10 < text * 9)
+		return "bin";				/* mostly not numbers: let main report it */
+
+	if (c.directive > 0)			/* comments may add a few letters */
+		return otherHex * 20 < c.binary ? "memb" : "memh";
+	if (otherHex * 20 > text && isHexWords(data, length, whole))
+		return "hex";
+	return "bin";
+}
+
+static void countClasses(const unsigned char sample[SNIFF_SIZE], CharClasses * counts)
+{
+	CharClasses c = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	unsigned int tabs = 0, slashes = 0, underscores = 0;
+	unsigned char b;
+	int i;
+
+	for (i = 0; i < SNIFF_SIZE; i++)
+	{
+		b = sample[i];
+		c.binary += (unsigned char)(b - '0') < 2;
+		c.decimal += (unsigned char)(b - '0') < 10;
+		c.hexLetter += (unsigned char)((b | 0x20) - 'a') < 6;
+		c.x += (b | 0x20) == 'x';
+		c.space += b == ' ';
+		tabs += (b == '\t') | (b == '\r');
+		c.newline += b == '\n';
+		c.directive += b == '@';
+		slashes += b == '/';
+		underscores += b == '_';
+		c.control += (b < ' ') | (b >= 0x7f);
+	}
+
+	/* Kept out of the loop, where the compiler would make a bit test of them. */
+	c.space += tabs;
+	c.control -= tabs + c.newline;
+	c.directive += slashes + underscores;
+
+	*counts = c;
+}
+
+/* Returns how many of the words in data are instructions findInstruction
+ * knows, reading them in the given byte order.
+ */
+static int instructionScore(const unsigned char * data, size_t length, int bigEndian)
+{
+	unsigned int word;
+	int score = 0;
+	size_t i;
+
+	for (i = 0; i + 4 <= length; i += 4)
+	{
+		word = bigEndian
+			? (unsigned int)data[i] << 24 | (unsigned int)data[i + 1] << 16
+			  | (unsigned int)data[i + 2] << 8 | data[i + 3]
+			: (unsigned int)data[i + 3] << 24 | (unsigned int)data[i + 2] << 16
+			  | (unsigned int)data[i + 1] << 8 | data[i];
+		score += findInstruction(word) != NULL;
+	}
+
+	return score;
+}
+
+/* Returns 1 if each line of data is hex words of 1 to 8 digits (each
+ * perhaps after 0x) separated by white space, and there is at least one
+ * word.  The last line is only looked at if whole says it is complete.
+ * Binary lines, of 32 digits, are not hex words.
+ */
+static int isHexWords(const unsigned char * data, size_t length, int whole)
+{
+	const unsigned char * end = data + length;
+	int words = 0;
+	int digits;
+
+	if (!whole)
+	{
+		while (end > data && end[-1] != '\n')
+			end--;				/* the line the sample cuts off */
+	}
+
+	while (data < end)
+	{
+		if (isspace(*data))
+		{
+			data++;
+			continue;
+		}
+		if (data + 1 < end && data[0] == '0' && (data[1] | 0x20) == 'x')
+			data += 2;
+		for (digits = 0; data < end && !isspace(*data); data++, digits++)
+		{
+			if (!isxdigit(*data))
+				return 0;
+		}
+		if (digits == 0 || digits > 8)
+			return 0;
+		words++;
+	}
+
+	return words > 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * verifyRoundTrip
+ *
+ * This file implements the --verify-roundtrip option.  Every valid
+ * input instruction is formatted by formatInstruction, the text is assembled
+ * again by assembleInstruction (in strict mode), and the resulting word
+ * is compared with the original.  Any difference means the printed
+ * instruction does not say what the machine would do, for example:
+ *      - an immediate printed unsigned that the instruction sign-extends
+ *        ("addi $t0, $t1, 65535" does not assemble in strict mode),
+ *      - a misspelled mnemonic, or operands printed in the wrong order,
+ *      - bits the formatter ignores (e.g. rs of sll), so that two
+ *        different words print the same way.
+ * Words whose opcode/funct is not in the instruction table are counted
+ * as unknown, not as mismatches.
+ *
+ * int verifyRoundTrip(LineReader * reader)
+ *   Output: one line per mismatch on stdout, in line order, then a
+ *           summary line.
+ *   Returns: the exit status for main (0 if there were no mismatches).
+ *
+ * Implementation:
+ *      The input is read in blocks of packed words.  Each block is split
+ *      into equal slices, one per thread (--threads, by default the
+ *      number of processors), and each thread records the mismatches in
+ *      its slice.  The slices are in order, so printing the threads'
+ *      records one after another keeps the report in line order.  The
+ *      formatter writes into a buffer the caller provides, so the threads
+ *      can share it.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "disassembler.h"
+
+#define ROUND_TRIP_BLOCK (1 << 20)	/* words checked per block */
+#define MAX_THREADS 64
+
+typedef struct
+{
+	int index;					/* position of the word in the block */
+	unsigned int reencoded;		/* what the printed text assembles to */
+	const char * error;			/* or why it does not assemble */
+} Mismatch;
+
+typedef struct
+{
+	const unsigned int * words;
+	int begin;
+	int end;
+	long unknown;
+	Mismatch * mismatches;
+	int count;
+	int capacity;
+	int failed;					/* 1 if mismatches could not grow */
+} Slice;
+
+static void * checkSlice(void * arg);
+static void describeDifference(unsigned int word, unsigned int reencoded, char * out);
+
+int verifyRoundTrip(LineReader * reader)
+{
+	static unsigned int words[ROUND_TRIP_BLOCK];
+	static int lineNums[ROUND_TRIP_BLOCK];
+	static Slice slices[MAX_THREADS];
+	pthread_t threads[MAX_THREADS];
+	int  started[MAX_THREADS];
+	long nThreads = (long)options.threads;
+	long total = 0;
+	long unknown = 0;
+	long mismatches = 0;
+	int  lineNum = 0;
+	int  count;
+	int  t, i;
+	char text[33];
+	char assembly[FORMAT_LIMIT];
+	char difference[64];
+
+	if (nThreads <= 0)
+		nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nThreads < 1)
+		nThreads = 1;
+	if (nThreads > MAX_THREADS)
+		nThreads = MAX_THREADS;
+
+	while ((count = readWordBlock(reader, words, lineNums, ROUND_TRIP_BLOCK, &lineNum)) > 0)
+	{
+		for (t = 0; t < nThreads; t++)
+		{
+			slices[t].words = words;
+			slices[t].begin = (int)((long)count * t / nThreads);
+			slices[t].end = (int)((long)count * (t + 1) / nThreads);
+			slices[t].unknown = 0;
+			slices[t].count = 0;
+			slices[t].failed = 0;
+		}
+
+		/* Slice 0 is checked by this thread; if a thread cannot be
+		 * started, its slice is checked here too.
+		 */
+		for (t = 1; t < nThreads; t++)
+			started[t] = (pthread_create(&threads[t], NULL, checkSlice, &slices[t]) == 0);
+		checkSlice(&slices[0]);
+		for (t = 1; t < nThreads; t++)
+		{
+			if (started[t])
+				pthread_join(threads[t], NULL);
+			else
+				checkSlice(&slices[t]);
+		}
+
+		for (t = 0; t < nThreads && !slices[t].failed; t++)
+			;
+		if (t < nThreads)
+		{
+			printError("Error: Not enough memory for the round trip mismatches.\n");
+			mismatches = -1;
+			break;
+		}
+
+		for (t = 0; t < nThreads; t++)
+		{
+			unknown += slices[t].unknown;
+			mismatches += slices[t].count;
+
+			for (i = 0; i < slices[t].count; i++)
+			{
+				const Mismatch * m = &slices[t].mismatches[i];
+
+				unpackMIPSInstruction(words[m->index], text);
+				formatInstruction(words[m->index], assembly);
+				if (m->error != NULL)
+				{
+					printf("Line %d: %s: \"%s\" does not assemble: %s\n",
+						   lineNums[m->index], text, assembly, m->error);
+				}
+				else
+				{
+					describeDifference(words[m->index], m->reencoded, difference);
+					printf("Line %d: %s: \"%s\" assembles to 0x%08x, not 0x%08x (%s)\n",
+						   lineNums[m->index], text, assembly, m->reencoded,
+						   words[m->index], difference);
+				}
+			}
+		}
+
+		total += count;
+	}
+
+	if (mismatches >= 0)
+		printf("Round trip: %ld instructions, %ld mismatches, %ld unknown\n",
+			   total, mismatches, unknown);
+
+	for (t = 0; t < MAX_THREADS; t++)
+	{
+		free(slices[t].mismatches);
+		slices[t].mismatches = NULL;
+		slices[t].capacity = 0;
+	}
+
+	return mismatches != 0 ? 1 : 0;
+}
+
+static void * checkSlice(void * arg)
+{
+	Slice * slice = arg;
+	Mismatch * more;
+	int capacity;
+	unsigned int word;
+	unsigned int reencoded;
+	const char * error;
+	char text[FORMAT_LIMIT];
+	int i;
+
+	for (i = slice->begin; i < slice->end; i++)
+	{
+		word = slice->words[i];
+
+		if (findInstruction(word) == NULL)
+		{
+			slice->unknown++;
+			continue;
+		}
+
+		formatInstruction(word, text);
+		error = assembleInstruction(text, &reencoded, 1);
+
+		if (error == NULL && reencoded == word)
+			continue;
+
+		if (slice->count == slice->capacity)
+		{
+			capacity = slice->capacity ? slice->capacity * 2 : 256;
+			more = realloc(slice->mismatches, (size_t)capacity * sizeof(Mismatch));
+			if (more == NULL)
+			{
+				slice->failed = 1;			/* reported by verifyRoundTrip */
+				return NULL;
+			}
+			slice->mismatches = more;
+			slice->capacity = capacity;
+		}
+		slice->mismatches[slice->count].index = i;
+		slice->mismatches[slice->count].reencoded = reencoded;
+		slice->mismatches[slice->count].error = error;
+		slice->count++;
+	}
+
+	return NULL;
+}
+
+/* Names the fields in which the two words differ, e.g. "rs, shamt". */
+static void describeDifference(unsigned int word, unsigned int reencoded, char * out)
+{
+	unsigned int diff = word ^ reencoded;
+	const InstrInfo * instr = findInstruction(word);
+
+	out[0] = '\0';
+	if (OPCODE(diff))
+		strcat(out, ", opcode");
+	if (instr != NULL && instr->format == 'J')
+	{
+		if (TARGET(diff))
+			strcat(out, ", target");
+	}
+	else if (instr != NULL && instr->format == 'I')
+	{
+		if (RS(diff))
+			strcat(out, ", rs");
+		if (RT(diff))
+			strcat(out, ", rt");
+		if (IMM(diff))
+			strcat(out, ", imm");
+	}
+	else
+	{
+		if (RS(diff))
+			strcat(out, ", rs");
+		if (RT(diff))
+			strcat(out, ", rt");
+		if (RD(diff))
+			strcat(out, ", rd");
+		if (SHAMT(diff))
+			strcat(out, ", shamt");
+		if (FUNCT(diff))
+			strcat(out, ", funct");
+	}
+
+	if (out[0] != '\0')
+		memmove(out, out + 2, strlen(out + 2) + 1);	/* drop the first ", " */
+}
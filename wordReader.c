@@ -0,0 +1,671 @@
+/*
+ * wordReader
+ *
+ * These functions read program images in the formats hardware tools
+ * produce, and return the instruction words in them with the address
+ * each is loaded at.
+ *
+ * LineReader * openInput(FILE * fptr)
+ *   Returns: a line reader for fptr (see lineReader.c), or NULL after
+ *            printing an error message.  The input is read as --input
+ *            says, or, if --input is not given or is "auto", as its first
+ *            bytes look (see sniffInput.c), except that --check, --pseudo
+ *            and --dict, which read binary lines, always read "bin" then,
+ *            so bad lines reach them as lines.  Unless that is "bin", lines
+ *            of 32 '0's and '1's, a word reader for it is set as the
+ *            reader's word source, which readWordBlock then uses.
+ *
+ * WordReader * openWordReader(LineReader * lines, const char * format)
+ *   Returns: a reader of the input from lines, which is in format, or
+ *            NULL (after printing an error message) if format is unknown
+ *            or an ELF file cannot be used.
+ *   The formats are
+ *      ihex    Intel HEX: data (00), end of file (01), extended segment
+ *              (02) and extended linear (04) address records
+ *      srec    Motorola S-records: data records S1, S2 and S3; S0, S5
+ *              and S6 are skipped and S7, S8 and S9 end the file
+ *      memh    Verilog $readmemh: hex words separated by white space,
+ *              with @address directives and // and block comments
+ *      memb    Verilog $readmemb: the same with binary words
+ *      hex     hex words, as for memh, which may also start with 0x
+ *      raw     the words themselves, 4 bytes each
+ *      elf     a 32-bit MIPS ELF file: the sections that hold code, or
+ *              if it has no section headers, the executable segments
+ *   For ihex, srec and raw the bytes are put together into words as
+ *   --endian says (big, the default, or little); an ELF file says its own
+ *   byte order.  ihex, srec and elf words are at their load addresses,
+ *   and a word only partly given has zeros in the missing bytes.  For
+ *   memh, memb and hex the addresses count words from --base, as the
+ *   indices of a Verilog memory do, and raw words are at --base onwards.
+ *
+ * int readWords(WordReader * reader, unsigned int words[],
+ *               unsigned int addresses[], int max)
+ *   Post-condition: words[0..n-1] hold the next words of the image and
+ *                   addresses[0..n-1] their addresses (unless addresses
+ *                   is NULL)
+ *   Returns: n, at most max; 0 only at the end of the image.
+ *   Output: A line that is not a valid record, or whose checksum is
+ *           wrong, is reported on stderr and skipped.
+ *
+ * void closeWordReader(WordReader * reader)
+ *   Frees the reader (but not its line reader).
+ *
+ * Implementation:
+ *      The records are parsed as they are read, one line at a time, so
+ *      an image of any size is read in a fixed amount of memory.  Hex
+ *      digits are decoded with a table indexed by the character, which
+ *      also marks the characters that are not hex digits, so each pair of
+ *      digits costs two loads; the checksum is summed as the bytes are
+ *      decoded.  The words found on a line are queued and handed out by
+ *      readWords in as large blocks as the caller asks for.  Raw words
+ *      are read straight into the caller's array and put in order there.
+ *      An ELF file is read into memory whole, since its headers say
+ *      where the code is; the code is then handed out from there.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+
+#include "disassembler.h"
+#include "wordReader.h"
+
+#define QUEUE_SIZE	(LINE_LIMIT + 8)	/* more than the words on one line */
+
+#define SNIFF_BYTES	4096				/* bytes sniffInput looks at */
+#define MAX_REGIONS	64					/* ELF sections or segments used */
+
+enum { FORMAT_IHEX, FORMAT_SREC, FORMAT_MEMH, FORMAT_MEMB, FORMAT_HEX,
+	   FORMAT_RAW, FORMAT_ELF, FORMATS };
+
+typedef struct
+{
+	uint32_t address;
+	size_t offset;				/* in the file */
+	size_t size;
+} Region;
+
+struct WordReader
+{
+	LineReader * lines;
+	int format;
+	int bigEndian;
+	int lineNum;
+	int done;					/* end of file record, or no more lines */
+	uint32_t upper;				/* ihex: extended segment or linear address */
+	uint32_t index;				/* memh, memb, hex, raw: next word */
+	int inComment;				/* memh, memb, hex: in a block comment */
+	uint32_t pendingAddress;	/* the word whose bytes are being gathered */
+	uint32_t pendingValue;
+	unsigned int pendingBytes;	/* bit i is set if byte i has been given */
+	unsigned int queueWords[QUEUE_SIZE];
+	unsigned int queueAddresses[QUEUE_SIZE];
+	int queueStart;
+	int queueEnd;
+	unsigned char * image;		/* elf: the whole file */
+	size_t imageSize;
+	Region regions[MAX_REGIONS];
+	int nRegions;
+	int region;					/* elf: the region being read */
+	size_t regionOffset;
+};
+
+/* Value of each hex digit plus 1; 0 for characters that are not digits. */
+static const unsigned char hexDigit[256] = {
+	['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+	['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+	['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+	['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16
+};
+
+static int readRaw(WordReader * r, unsigned int words[], unsigned int addresses[], int max);
+static int readElf(WordReader * r, unsigned int words[], unsigned int addresses[], int max);
+static int loadElf(WordReader * r);
+static uint32_t getWord(const unsigned char * bytes, int bigEndian);
+static uint32_t getHalf(const unsigned char * bytes, int bigEndian);
+static void parseLine(WordReader * r, char * line, int length);
+static void parseIntelHex(WordReader * r, const char * line, int length);
+static void parseSRecord(WordReader * r, const char * line, int length);
+static void parseMemory(WordReader * r, char * line);
+static int decodeBytes(const char * text, int nBytes, unsigned char bytes[], unsigned int * sum);
+static void putByte(WordReader * r, uint32_t address, unsigned int byte);
+static void flushPending(WordReader * r);
+static void queueWord(WordReader * r, unsigned int word, uint32_t address);
+static void badLine(WordReader * r, const char * why);
+
+LineReader * openInput(FILE * fptr)
+{
+	LineReader * reader;
+	WordReader * words;
+	const unsigned char * data;
+	const char * format = options.inputFormat;
+	size_t length;
+	int bigEndian = 1;
+
+	if ((reader = openLineReader(fptr)) == NULL)
+		return NULL;
+
+	if ((format == NULL || strcmp(format, "auto") == SAME)
+		&& (options.check || options.pseudo || options.dict))
+		format = "bin";
+	else if (format == NULL || strcmp(format, "auto") == SAME)
+	{
+		length = peekInput(reader, &data, SNIFF_BYTES);
+		format = sniffInput(data, length, &bigEndian);
+		if (strcmp(format, "raw") == SAME && options.endian == NULL)
+			options.endian = bigEndian ? "big" : "little";
+		printDebug("Input format: %s\n", format);
+	}
+
+	if (strcmp(format, "bin") != SAME)
+	{
+		if ((words = openWordReader(reader, format)) == NULL)
+		{
+			closeLineReader(reader);
+			return NULL;
+		}
+		setWordSource(reader, words);
+	}
+
+	return reader;
+}
+
+WordReader * openWordReader(LineReader * lines, const char * format)
+{
+	static const char * const names[FORMATS] =
+		{ "ihex", "srec", "memh", "memb", "hex", "raw", "elf" };
+	WordReader * r;
+	int f;
+
+	for (f = 0; f < FORMATS && strcmp(format, names[f]) != SAME; f++)
+		;
+	if (f == FORMATS)
+	{
+		printError("Error: Unknown input format %s (use auto, bin, hex, raw, elf, ihex, "
+				   "srec, memh or memb).\n", format);
+		return NULL;
+	}
+	if (options.endian != NULL && strcmp(options.endian, "big") != SAME
+		&& strcmp(options.endian, "little") != SAME)
+	{
+		printError("Error: Unknown byte order %s (use big or little).\n", options.endian);
+		return NULL;
+	}
+
+	if ((r = calloc(1, sizeof(WordReader))) == NULL)
+	{
+		printError("Error: Not enough memory for the input reader.\n");
+		return NULL;
+	}
+	r->lines = lines;
+	r->format = f;
+	r->bigEndian = options.endian == NULL || strcmp(options.endian, "big") == SAME;
+
+	if (f == FORMAT_ELF && !loadElf(r))
+	{
+		closeWordReader(r);
+		return NULL;
+	}
+	return r;
+}
+
+int readWords(WordReader * r, unsigned int words[], unsigned int addresses[], int max)
+{
+	char * line;
+	int length;
+	int count = 0;
+
+	if (r->format == FORMAT_RAW)
+		return readRaw(r, words, addresses, max);
+	if (r->format == FORMAT_ELF)
+		return readElf(r, words, addresses, max);
+
+	while (count < max)
+	{
+		if (r->queueStart == r->queueEnd)
+		{
+			r->queueStart = r->queueEnd = 0;
+			if (r->done)
+				break;
+			if ((line = readLine(r->lines, &length)) == NULL)
+			{
+				r->done = 1;
+				flushPending(r);
+				continue;
+			}
+			r->lineNum++;
+			parseLine(r, line, length);
+			continue;
+		}
+
+		words[count] = r->queueWords[r->queueStart];
+		if (addresses != NULL)
+			addresses[count] = r->queueAddresses[r->queueStart];
+		r->queueStart++;
+		count++;
+	}
+
+	return count;
+}
+
+void closeWordReader(WordReader * r)
+{
+	free(r->image);
+	free(r);
+}
+
+static int readRaw(WordReader * r, unsigned int words[], unsigned int addresses[], int max)
+{
+	size_t got;
+	int n, k;
+
+	if (r->done)
+		return 0;
+
+	got = readBytes(r->lines, words, (size_t)max * 4);
+	n = (int)(got / 4);
+	if (got % 4 != 0)
+	{
+		memset((unsigned char *)words + got, 0, 4 - got % 4);
+		printError("Error: The input ends in a partial word.\n");
+		n++;
+	}
+	if (got < (size_t)max * 4)
+		r->done = 1;
+
+	for (k = 0; k < n; k++)
+	{
+		words[k] = getWord((unsigned char *)&words[k], r->bigEndian);
+		if (addresses != NULL)
+			addresses[k] = (uint32_t)options.textBase + 4 * r->index;
+		r->index++;
+	}
+
+	return n;
+}
+
+static int readElf(WordReader * r, unsigned int words[], unsigned int addresses[], int max)
+{
+	Region * g;
+	int count = 0;
+
+	while (count < max && r->region < r->nRegions)
+	{
+		g = &r->regions[r->region];
+		if (r->regionOffset + 4 > g->size)
+		{
+			r->region++;
+			r->regionOffset = 0;
+			continue;
+		}
+		words[count] = getWord(r->image + g->offset + r->regionOffset, r->bigEndian);
+		if (addresses != NULL)
+			addresses[count] = g->address + (uint32_t)r->regionOffset;
+		r->regionOffset += 4;
+		count++;
+	}
+
+	return count;
+}
+
+/* Reads the whole ELF file and finds the regions that hold code: the
+ * SHT_PROGBITS sections with SHF_EXECINSTR set, or if there are none,
+ * the PT_LOAD segments with PF_X set.  Returns 0 if there are none.
+ */
+static int loadElf(WordReader * r)
+{
+	size_t capacity = 1 << 20;
+	size_t got;
+	const unsigned char * h;
+	const unsigned char * e;
+	uint32_t offset, size, entrySize, count, i;
+	int big;
+
+	r->image = malloc(capacity);
+	while (r->image != NULL
+		   && (got = readBytes(r->lines, r->image + r->imageSize, capacity - r->imageSize)) > 0)
+	{
+		r->imageSize += got;
+		if (r->imageSize < capacity)
+			break;
+		capacity *= 2;
+		r->image = realloc(r->image, capacity);
+	}
+	if (r->image == NULL)
+	{
+		printError("Error: Not enough memory for the ELF file.\n");
+		return 0;
+	}
+
+	h = r->image;
+	if (r->imageSize < 52 || h[4] != 1 || (h[5] != 1 && h[5] != 2))
+	{
+		printError("Error: Only 32-bit ELF files can be read.\n");
+		return 0;
+	}
+	big = r->bigEndian = h[5] == 2;
+	if (getHalf(h + 18, big) != 8 && getHalf(h + 18, big) != 10)
+	{
+		printError("Error: The ELF file is not for MIPS (machine %u).\n", getHalf(h + 18, big));
+		return 0;
+	}
+
+	/* Sections: e_shoff, e_shentsize and e_shnum. */
+	offset = getWord(h + 32, big);
+	entrySize = getHalf(h + 46, big);
+	count = getHalf(h + 48, big);
+	if (offset != 0 && entrySize >= 40 && offset <= r->imageSize
+		&& count <= (r->imageSize - offset) / entrySize)
+	{
+		for (i = 0; i < count && r->nRegions < MAX_REGIONS; i++)
+		{
+			e = h + offset + i * entrySize;
+			size = getWord(e + 20, big);
+			if (getWord(e + 4, big) == 1 && (getWord(e + 8, big) & 4) && size > 0
+				&& getWord(e + 16, big) <= r->imageSize
+				&& size <= r->imageSize - getWord(e + 16, big))
+			{
+				r->regions[r->nRegions].address = getWord(e + 12, big);
+				r->regions[r->nRegions].offset = getWord(e + 16, big);
+				r->regions[r->nRegions].size = size;
+				r->nRegions++;
+			}
+		}
+	}
+
+	/* Segments: e_phoff, e_phentsize and e_phnum. */
+	offset = getWord(h + 28, big);
+	entrySize = getHalf(h + 42, big);
+	count = getHalf(h + 44, big);
+	if (r->nRegions == 0 && offset != 0 && entrySize >= 32 && offset <= r->imageSize
+		&& count <= (r->imageSize - offset) / entrySize)
+	{
+		for (i = 0; i < count && r->nRegions < MAX_REGIONS; i++)
+		{
+			e = h + offset + i * entrySize;
+			size = getWord(e + 16, big);
+			if (getWord(e, big) == 1 && (getWord(e + 24, big) & 1) && size > 0
+				&& getWord(e + 4, big) <= r->imageSize
+				&& size <= r->imageSize - getWord(e + 4, big))
+			{
+				r->regions[r->nRegions].address = getWord(e + 8, big);
+				r->regions[r->nRegions].offset = getWord(e + 4, big);
+				r->regions[r->nRegions].size = size;
+				r->nRegions++;
+			}
+		}
+	}
+
+	if (r->nRegions == 0)
+	{
+		printError("Error: The ELF file has no code.\n");
+		return 0;
+	}
+	return 1;
+}
+
+static uint32_t getWord(const unsigned char * bytes, int bigEndian)
+{
+	if (bigEndian)
+		return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16
+			   | (uint32_t)bytes[2] << 8 | bytes[3];
+	return (uint32_t)bytes[3] << 24 | (uint32_t)bytes[2] << 16
+		   | (uint32_t)bytes[1] << 8 | bytes[0];
+}
+
+static uint32_t getHalf(const unsigned char * bytes, int bigEndian)
+{
+	return bigEndian ? (uint32_t)bytes[0] << 8 | bytes[1] : (uint32_t)bytes[1] << 8 | bytes[0];
+}
+
+static void parseLine(WordReader * r, char * line, int length)
+{
+	switch (r->format)
+	{
+		case FORMAT_IHEX :
+			parseIntelHex(r, line, length);
+		break;
+
+		case FORMAT_SREC :
+			parseSRecord(r, line, length);
+		break;
+
+		default :
+			parseMemory(r, line);
+		break;
+	}
+}
+
+/* :LLAAAATT<data>CC, where the bytes, CC included, sum to 0. */
+static void parseIntelHex(WordReader * r, const char * line, int length)
+{
+	unsigned char bytes[260];
+	unsigned int sum = 0;
+	int nBytes = (length - 1) / 2;
+	uint32_t address;
+	int i;
+
+	if (length == 0)
+		return;
+	if (line[0] != ':' || length % 2 == 0 || nBytes < 5 || nBytes > 260
+		|| !decodeBytes(line + 1, nBytes, bytes, &sum) || nBytes != bytes[0] + 5)
+	{
+		badLine(r, "is not an Intel HEX record");
+		return;
+	}
+	if ((sum & 0xFF) != 0)
+	{
+		badLine(r, "has a bad checksum");
+		return;
+	}
+
+	address = ((uint32_t)bytes[1] << 8) | bytes[2];
+	switch (bytes[3])
+	{
+		case 0x00 :										/* data */
+			for (i = 0; i < bytes[0]; i++)
+				putByte(r, r->upper + address + (uint32_t)i, bytes[4 + i]);
+		break;
+
+		case 0x01 :										/* end of file */
+			flushPending(r);
+			r->done = 1;
+		break;
+
+		case 0x02 :										/* extended segment address */
+		case 0x04 :										/* extended linear address */
+			if (bytes[0] != 2)
+			{
+				badLine(r, "has a bad length for an address record");
+				return;
+			}
+			r->upper = (((uint32_t)bytes[4] << 8) | bytes[5]) << (bytes[3] == 0x02 ? 4 : 16);
+		break;
+
+		case 0x03 :										/* start addresses */
+		case 0x05 :
+		break;
+
+		default :
+			badLine(r, "has an unknown record type");
+		break;
+	}
+}
+
+/* Stcc<address><data>ss, where ss is the ones' complement of the sum of
+ * the other bytes and cc counts the bytes after it.
+ */
+static void parseSRecord(WordReader * r, const char * line, int length)
+{
+	static const int addressBytes[10] = { 2, 2, 3, 4, 0, 2, 3, 4, 3, 2 };
+	unsigned char bytes[260];
+	unsigned int sum = 0;
+	int nBytes = (length - 2) / 2;
+	int type;
+	uint32_t address = 0;
+	int i;
+
+	if (length == 0)
+		return;
+	if (line[0] != 'S' || line[1] < '0' || line[1] > '9' || line[1] == '4'
+		|| length % 2 != 0 || nBytes < 3 || nBytes > 256
+		|| !decodeBytes(line + 2, nBytes, bytes, &sum) || nBytes != bytes[0] + 1)
+	{
+		badLine(r, "is not an S-record");
+		return;
+	}
+	if ((sum & 0xFF) != 0xFF)		/* the bytes plus the checksum */
+	{
+		badLine(r, "has a bad checksum");
+		return;
+	}
+
+	type = line[1] - '0';
+	if (bytes[0] < addressBytes[type] + 1)
+	{
+		badLine(r, "is too short for its address");
+		return;
+	}
+	for (i = 0; i < addressBytes[type]; i++)
+		address = (address << 8) | bytes[1 + i];
+
+	if (type >= 1 && type <= 3)
+	{
+		for (i = 1 + addressBytes[type]; i < bytes[0]; i++)
+			putByte(r, address++, bytes[i]);
+	}
+	else if (type >= 7)
+	{
+		flushPending(r);
+		r->done = 1;
+	}
+}
+
+/* White space separated words, @address directives and comments. */
+static void parseMemory(WordReader * r, char * line)
+{
+	char * p = line;
+	unsigned int word, digit;
+	int isAddress;
+	int digits;
+	int bits = r->format == FORMAT_MEMB ? 1 : 4;
+	int shift;
+
+	while (*p != '\0')
+	{
+		if (r->inComment)
+		{
+			if ((p = strstr(p, "*/")) == NULL)
+				return;
+			p += 2;
+			r->inComment = 0;
+			continue;
+		}
+		if (isspace((unsigned char)*p))
+		{
+			p++;
+			continue;
+		}
+		if (p[0] == '/' && p[1] == '/')
+			return;
+		if (p[0] == '/' && p[1] == '*')
+		{
+			r->inComment = 1;
+			p += 2;
+			continue;
+		}
+
+		isAddress = *p == '@';
+		if (isAddress)
+			p++;
+		else if (r->format == FORMAT_HEX && p[0] == '0' && (p[1] | 0x20) == 'x')
+			p += 2;
+		shift = isAddress ? 4 : bits;
+		word = 0;
+		digits = 0;
+		for (; *p != '\0' && !isspace((unsigned char)*p) && *p != '/'; p++)
+		{
+			digit = hexDigit[(unsigned char)*p];
+			if (*p == '_')
+				continue;
+			if (digit == 0 || digit - 1 >= 1U << shift)
+			{
+				digits = -1;
+				break;
+			}
+			word = (word << shift) | (digit - 1);
+			digits++;
+		}
+
+		if (digits <= 0 || digits > 32 / shift)
+		{
+			badLine(r, isAddress ? "has a bad address" : "has a bad word");
+			while (*p != '\0' && !isspace((unsigned char)*p))
+				p++;
+			continue;
+		}
+
+		if (isAddress)
+			r->index = word;
+		else
+			queueWord(r, word, (uint32_t)options.textBase + 4 * r->index++);
+	}
+}
+
+/* Decodes 2 * nBytes hex digits, adding the bytes to *sum.  Returns 0 if
+ * a character is not a hex digit.
+ */
+static int decodeBytes(const char * text, int nBytes, unsigned char bytes[], unsigned int * sum)
+{
+	unsigned int high, low;
+	int i;
+
+	for (i = 0; i < nBytes; i++)
+	{
+		high = hexDigit[(unsigned char)text[2 * i]];
+		low = hexDigit[(unsigned char)text[2 * i + 1]];
+		if (high == 0 || low == 0)
+			return 0;
+		bytes[i] = (unsigned char)(((high - 1) << 4) | (low - 1));
+		*sum += bytes[i];
+	}
+
+	return 1;
+}
+
+/* Adds one byte of an ihex or srec image to the word it belongs in. */
+static void putByte(WordReader * r, uint32_t address, unsigned int byte)
+{
+	uint32_t wordAddress = address & ~3U;
+	unsigned int lane = address & 3;
+	unsigned int shift = r->bigEndian ? 8 * (3 - lane) : 8 * lane;
+
+	if (r->pendingBytes != 0 && wordAddress != r->pendingAddress)
+		flushPending(r);
+
+	r->pendingAddress = wordAddress;
+	r->pendingValue |= (uint32_t)byte << shift;
+	r->pendingBytes |= 1U << lane;
+	if (r->pendingBytes == 0xF)
+		flushPending(r);
+}
+
+static void flushPending(WordReader * r)
+{
+	if (r->pendingBytes != 0)
+		queueWord(r, r->pendingValue, r->pendingAddress);
+	r->pendingValue = 0;
+	r->pendingBytes = 0;
+}
+
+static void queueWord(WordReader * r, unsigned int word, uint32_t address)
+{
+	r->queueWords[r->queueEnd] = word;
+	r->queueAddresses[r->queueEnd] = address;
+	r->queueEnd++;
+}
+
+static void badLine(WordReader * r, const char * why)
+{
+	printError("Error: Line %d %s.\n", r->lineNum, why);
+}
@@ -0,0 +1,19 @@
+/*
+ * This file provides the signatures for the word reader, which reads
+ * program images in formats other than one binary line per instruction
+ * and returns each instruction word with its address (see wordReader.c).
+ */
+
+#ifndef _WORD_READER_H
+#define _WORD_READER_H
+
+#include "lineReader.h"
+
+typedef struct WordReader WordReader;
+
+LineReader * openInput(FILE * fptr);
+WordReader * openWordReader(LineReader * lines, const char * format);
+int readWords(WordReader * reader, unsigned int words[], unsigned int addresses[], int max);
+void closeWordReader(WordReader * reader);
+
+#endif
@@ -0,0 +1,577 @@
+/*
+ * xref
+ *
+ * This file implements the --xref and --refs options: a cross-reference
+ * index of the lines where each register is read or written, where each
+ * branch or jump target is referred to, and where each immediate value
+ * appears.  The index can be saved to a file, so questions such as "who
+ * jumps to 0x00400120" are answered without disassembling the input
+ * again.
+ *
+ * int buildXref(LineReader * reader, const char * path)
+ *   Reads the whole input in one pass and saves its index in path.
+ *   Returns: the exit status for main.
+ *
+ * int queryXref(LineReader * reader, const char * key, const char * path)
+ *   Prints the lines recorded under key, one "Line N" per line (or, with
+ *   --count, how many there are).  key is one of
+ *          reads=$t0           lines that read a register
+ *          writes=$t0          lines that write a register
+ *          target=0x00400120   branches and jumps to an address
+ *          imm=-4              lines with an immediate (arithmetic,
+ *                              logical, lui, load and store offsets)
+ *   Registers may be given by name or number, and an immediate as the
+ *   signed or the unsigned 16-bit value.  The index is loaded from path
+ *   if it is not NULL (reader is not used and may be NULL), and is built
+ *   from the input otherwise.
+ *   Returns: the exit status for main.
+ *
+ * Registers are read and written as instructionDefUse (liveness.c) says,
+ * except that jal is recorded as writing $ra only, not as a call that
+ * reads the arguments and clobbers the caller-saved registers.  Target
+ * addresses are worked out as in the simulator, from the addresses the
+ * image gives, or for lines, with the valid instructions at --base,
+ * --base + 4, and so on.
+ *
+ * File layout:
+ *      A 16 byte header (the magic "MIPSXREF", the number of keys and the
+ *      address of the first instruction), then the keys, each 24 bytes (kind, value, number
+ *      of lines, bytes of lines, and 64-bit offset), sorted by kind and
+ *      value, then the lines of every key.  Numbers are in the byte order
+ *      of the machine that wrote the file.
+ *
+ * Implementation:
+ *      Each key's lines are kept as one array of bytes: the difference
+ *      from the previous line (the first from 0) as a variable-length
+ *      integer, 7 bits per byte with the high bit set on all but the
+ *      last byte.  Lines are usually close together, so most take one
+ *      or two bytes, and adding one is an append to the key's array, not
+ *      a new node.  The 64 register keys and 65536 immediate keys are
+ *      indexed directly; targets go in an open-addressing hash table.
+ *      The finished index is laid out exactly as in the file, in memory
+ *      or in a mapping of the file, and a query finds its key by binary
+ *      search and decodes only that key's lines.
+ *
+ * Creation Date:  10/19/2026
+ */
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "disassembler.h"
+
+#define XREF_MAGIC		"MIPSXREF"
+#define XREF_BLOCK		65536		/* words read at a time */
+#define IMM_KEYS		65536
+
+enum { KIND_READS, KIND_WRITES, KIND_TARGET, KIND_IMM };
+
+typedef struct
+{
+	char magic[8];
+	uint32_t nKeys;
+	uint32_t base;
+} XrefHeader;
+
+typedef struct
+{
+	uint32_t kind;
+	uint32_t value;
+	uint32_t count;			/* number of lines */
+	uint32_t length;		/* bytes of encoded lines */
+	uint64_t offset;		/* of the lines, from the start of the index */
+} XrefKey;
+
+/* The lines of one key, while the index is built. */
+typedef struct
+{
+	uint8_t * bytes;
+	uint32_t length;
+	uint32_t capacity;
+	uint32_t count;
+	int32_t last;			/* the last line added */
+} RefList;
+
+typedef struct
+{
+	uint32_t address;
+	RefList refs;
+} TargetRefs;
+
+typedef struct
+{
+	RefList reads[32];
+	RefList writes[32];
+	RefList * imms;			/* IMM_KEYS of them */
+	TargetRefs * targets;	/* hash table; refs.count == 0 if free */
+	uint32_t nTargets;
+	uint32_t targetSlots;	/* a power of 2 */
+	uint32_t base;
+} XrefBuilder;
+
+static int addWord(XrefBuilder * b, unsigned int word, unsigned int address, int lineNum);
+static int addLine(RefList * list, int lineNum);
+static RefList * findTarget(XrefBuilder * b, uint32_t address);
+static void * layoutIndex(XrefBuilder * b, size_t * size);
+static int putKey(XrefKey * keys, uint8_t * data, uint64_t * offset,
+				  uint32_t kind, uint32_t value, RefList * list);
+static int compareKeys(const void * a, const void * b);
+static void freeBuilder(XrefBuilder * b);
+static void * buildIndex(LineReader * reader, size_t * size, int * count);
+static int parseKey(const char * text, uint32_t * kind, uint32_t * value);
+static const XrefKey * findKey(const void * index, uint32_t kind, uint32_t value);
+
+int buildXref(LineReader * reader, const char * path)
+{
+	const XrefHeader * header;
+	void * index;
+	size_t size;
+	int count;
+	FILE * out;
+
+	if ((index = buildIndex(reader, &size, &count)) == NULL)
+	{
+		return 1;
+	}
+
+	if ((out = fopen(path, "wb")) == NULL || fwrite(index, 1, size, out) != size
+		|| fclose(out) != 0)
+	{
+		printError("Error: Cannot write the cross-reference index %s.\n", path);
+		free(index);
+		return 1;
+	}
+
+	header = index;
+	printf("Indexed %d instructions: %u keys, %zu bytes in %s\n",
+		   count, header->nKeys, size, path);
+	free(index);
+	return 0;
+}
+
+int queryXref(LineReader * reader, const char * key, const char * path)
+{
+	const XrefKey * found;
+	const uint8_t * bytes;
+	void * index;
+	size_t size;
+	struct stat info;
+	uint32_t kind, value, i;
+	uint32_t line = 0;
+	int count;
+	int shift;
+	int fd;
+
+	if (!parseKey(key, &kind, &value))
+	{
+		return 1;
+	}
+
+	if (path == NULL)
+	{
+		if ((index = buildIndex(reader, &size, &count)) == NULL)
+			return 1;
+	}
+	else
+	{
+		if ((fd = open(path, O_RDONLY)) < 0 || fstat(fd, &info) != 0)
+		{
+			printError("Error: Cannot open the cross-reference index %s.\n", path);
+			if (fd >= 0)
+				close(fd);
+			return 1;
+		}
+		size = (size_t)info.st_size;
+		index = size >= sizeof(XrefHeader) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)
+			: MAP_FAILED;
+		close(fd);
+		if (index == MAP_FAILED
+			|| memcmp(((const XrefHeader *)index)->magic, XREF_MAGIC, 8) != SAME
+			|| sizeof(XrefHeader) + (size_t)((const XrefHeader *)index)->nKeys
+			   * sizeof(XrefKey) > size)
+		{
+			printError("Error: %s is not a cross-reference index.\n", path);
+			if (index != MAP_FAILED)
+				munmap(index, size);
+			return 1;
+		}
+	}
+
+	found = findKey(index, kind, value);
+	if (found != NULL && found->offset + found->length > size)
+	{
+		printError("Error: The cross-reference index is damaged.\n");
+		found = NULL;
+	}
+
+	if (options.count)
+	{
+		printf("%u\n", found != NULL ? found->count : 0);
+	}
+	else if (found != NULL)
+	{
+		bytes = (const uint8_t *)index + found->offset;
+		for (i = 0; i < found->length; )
+		{
+			uint32_t delta = 0;
+
+			for (shift = 0; bytes[i] & 0x80; shift += 7)
+				delta |= (uint32_t)(bytes[i++] & 0x7F) << shift;
+			delta |= (uint32_t)bytes[i++] << shift;
+
+			line += delta;
+			printf("Line %u\n", line);
+		}
+	}
+
+	if (path == NULL)
+		free(index);
+	else
+		munmap(index, size);
+	return 0;
+}
+
+/* Reads the input and returns its index, laid out as in the file, in
+ * new memory the caller frees; *size is its size and *count the number
+ * of instructions.  Returns NULL after printing an error message if
+ * there are no instructions or not enough memory.
+ */
+static void * buildIndex(LineReader * reader, size_t * size, int * count)
+{
+	static unsigned int words[XREF_BLOCK];
+	static int lineNums[XREF_BLOCK];
+	static unsigned int addresses[XREF_BLOCK];
+	static XrefBuilder b;
+	void * index;
+	unsigned int next = (unsigned int)options.textBase;
+	int lineNum = 0;
+	int n, i;
+
+	memset(&b, 0, sizeof(b));
+	b.imms = calloc(IMM_KEYS, sizeof(RefList));
+	b.targets = calloc(1024, sizeof(TargetRefs));
+	if (b.imms == NULL || b.targets == NULL)
+	{
+		printError("Error: Not enough memory for the cross-reference index.\n");
+		freeBuilder(&b);
+		return NULL;
+	}
+	b.targetSlots = 1024;
+	*count = 0;
+
+	while ((n = readAddressBlock(reader, words, addresses, lineNums, XREF_BLOCK,
+								 &lineNum, &next)) > 0)
+	{
+		if (*count == 0)
+			b.base = addresses[0];
+		for (i = 0; i < n; i++, (*count)++)
+		{
+			if (!addWord(&b, words[i], addresses[i], lineNums[i]))
+			{
+				printError("Error: Not enough memory for the cross-reference index.\n");
+				freeBuilder(&b);
+				return NULL;
+			}
+		}
+	}
+
+	if (*count == 0)
+	{
+		printError("Error: The program has no instructions.\n");
+		freeBuilder(&b);
+		return NULL;
+	}
+
+	index = layoutIndex(&b, size);
+	freeBuilder(&b);
+	if (index == NULL)
+		printError("Error: Not enough memory for the cross-reference index.\n");
+	return index;
+}
+
+/* Adds the keys of one instruction.  Returns 0 if there is not enough
+ * memory for them.
+ */
+static int addWord(XrefBuilder * b, unsigned int word, unsigned int address, int lineNum)
+{
+	const InstrInfo * instr = findInstruction(word);
+	RefList * list;
+	unsigned int def, use;
+	int r;
+
+	if (instr == NULL)
+		return 1;
+
+	if (instr->opcode == 3)							/* jal */
+	{
+		def = 1U << 31;
+		use = 0;
+	}
+	else
+	{
+		instructionDefUse(word, &def, &use);
+	}
+	for (r = 1; r < 32; r++)
+	{
+		if ((use & (1U << r)) && !addLine(&b->reads[r], lineNum))
+			return 0;
+		if ((def & (1U << r)) && !addLine(&b->writes[r], lineNum))
+			return 0;
+	}
+
+	switch (instr->layout)
+	{
+		case LAYOUT_BRANCH :
+			list = findTarget(b, address + 4 + ((uint32_t)(int16_t)IMM(word) << 2));
+		break;
+
+		case LAYOUT_JUMP :
+			list = findTarget(b, ((address + 4) & 0xF0000000) | (TARGET(word) << 2));
+		break;
+
+		case LAYOUT_ARITH :
+		case LAYOUT_LUI :
+		case LAYOUT_MEM :
+			list = &b->imms[IMM(word)];
+		break;
+
+		default :
+			return 1;
+	}
+	return list != NULL && addLine(list, lineNum);
+}
+
+/* Appends a line, as its distance from the last one, to a key's lines.
+ * Returns 0 if there is not enough memory for it.
+ */
+static int addLine(RefList * list, int lineNum)
+{
+	uint32_t delta = (uint32_t)(lineNum - list->last);
+	uint32_t capacity;
+	uint8_t * bytes;
+
+	if (list->length + 5 > list->capacity)
+	{
+		capacity = list->capacity ? list->capacity * 2 : 16;
+		if ((bytes = realloc(list->bytes, capacity)) == NULL)
+			return 0;
+		list->bytes = bytes;
+		list->capacity = capacity;
+	}
+
+	while (delta >= 0x80)
+	{
+		list->bytes[list->length++] = (uint8_t)(delta | 0x80);
+		delta >>= 7;
+	}
+	list->bytes[list->length++] = (uint8_t)delta;
+
+	list->last = lineNum;
+	list->count++;
+	return 1;
+}
+
+/* Returns the lines of a target address, adding the address if it is new,
+ * or NULL if there is not enough memory to add it.
+ */
+static RefList * findTarget(XrefBuilder * b, uint32_t address)
+{
+	TargetRefs * old;
+	uint32_t slot;
+	uint32_t i;
+
+	if (2 * (b->nTargets + 1) > b->targetSlots)
+	{
+		old = b->targets;
+		if ((b->targets = calloc(2 * (size_t)b->targetSlots, sizeof(TargetRefs))) == NULL)
+		{
+			b->targets = old;
+			return NULL;
+		}
+		b->targetSlots *= 2;
+		for (i = 0; i < b->targetSlots / 2; i++)
+		{
+			if (old[i].refs.count == 0)
+				continue;
+			for (slot = (old[i].address * 0x9E3779B1U) & (b->targetSlots - 1);
+				 b->targets[slot].refs.count != 0; slot = (slot + 1) & (b->targetSlots - 1))
+				;
+			b->targets[slot] = old[i];
+		}
+		free(old);
+	}
+
+	for (slot = (address * 0x9E3779B1U) & (b->targetSlots - 1);
+		 b->targets[slot].refs.count != 0; slot = (slot + 1) & (b->targetSlots - 1))
+	{
+		if (b->targets[slot].address == address)
+			return &b->targets[slot].refs;
+	}
+
+	b->nTargets++;
+	b->targets[slot].address = address;
+	return &b->targets[slot].refs;		/* count becomes 1 when the line is added */
+}
+
+/* Lays out the finished index as it is saved: header, sorted keys, lines. */
+static void * layoutIndex(XrefBuilder * b, size_t * size)
+{
+	XrefHeader * header;
+	XrefKey * keys;
+	uint8_t * data;
+	uint64_t offset;
+	uint32_t nKeys = 0;
+	uint32_t i;
+	size_t bytes = 0;
+	int r;
+
+	for (r = 0; r < 32; r++)
+	{
+		nKeys += (b->reads[r].count > 0) + (b->writes[r].count > 0);
+		bytes += b->reads[r].length + b->writes[r].length;
+	}
+	for (i = 0; i < IMM_KEYS; i++)
+	{
+		nKeys += b->imms[i].count > 0;
+		bytes += b->imms[i].length;
+	}
+	for (i = 0; i < b->targetSlots; i++)
+		bytes += b->targets[i].refs.length;
+	nKeys += b->nTargets;
+
+	offset = sizeof(XrefHeader) + (uint64_t)nKeys * sizeof(XrefKey);
+	*size = (size_t)offset + bytes;
+	if ((header = malloc(*size)) == NULL)
+		return NULL;
+	memcpy(header->magic, XREF_MAGIC, sizeof(header->magic));
+	header->nKeys = nKeys;
+	header->base = b->base;
+	keys = (XrefKey *)(header + 1);
+	data = (uint8_t *)header;
+
+	nKeys = 0;
+	for (r = 0; r < 32; r++)
+		nKeys += putKey(keys + nKeys, data, &offset, KIND_READS, (uint32_t)r, &b->reads[r]);
+	for (r = 0; r < 32; r++)
+		nKeys += putKey(keys + nKeys, data, &offset, KIND_WRITES, (uint32_t)r, &b->writes[r]);
+	for (i = 0; i < b->targetSlots; i++)
+	{
+		nKeys += putKey(keys + nKeys, data, &offset, KIND_TARGET, b->targets[i].address,
+						&b->targets[i].refs);
+	}
+	qsort(keys + nKeys - b->nTargets, b->nTargets, sizeof(XrefKey), compareKeys);
+	for (i = 0; i < IMM_KEYS; i++)
+		nKeys += putKey(keys + nKeys, data, &offset, KIND_IMM, i, &b->imms[i]);
+
+	return header;
+}
+
+/* Copies a key's lines into the index, unless it has none.  Returns 1 if
+ * it was added.
+ */
+static int putKey(XrefKey * key, uint8_t * data, uint64_t * offset,
+				  uint32_t kind, uint32_t value, RefList * list)
+{
+	if (list->count == 0)
+		return 0;
+
+	key->kind = kind;
+	key->value = value;
+	key->count = list->count;
+	key->length = list->length;
+	key->offset = *offset;
+	memcpy(data + *offset, list->bytes, list->length);
+	*offset += list->length;
+	return 1;
+}
+
+static int compareKeys(const void * a, const void * b)
+{
+	const XrefKey * x = a;
+	const XrefKey * y = b;
+
+	if (x->kind != y->kind)
+		return x->kind < y->kind ? -1 : 1;
+	return (x->value > y->value) - (x->value < y->value);
+}
+
+static void freeBuilder(XrefBuilder * b)
+{
+	uint32_t i;
+	int r;
+
+	for (r = 0; r < 32; r++)
+	{
+		free(b->reads[r].bytes);
+		free(b->writes[r].bytes);
+	}
+	for (i = 0; b->imms != NULL && i < IMM_KEYS; i++)
+		free(b->imms[i].bytes);
+	for (i = 0; b->targets != NULL && i < b->targetSlots; i++)
+		free(b->targets[i].refs.bytes);
+	free(b->imms);
+	free(b->targets);
+}
+
+/* Turns "reads=$t0", "target=0x400120" and so on into a kind and value. */
+static int parseKey(const char * text, uint32_t * kind, uint32_t * value)
+{
+	static const char * const kinds[] = { "reads=", "writes=", "target=", "imm=" };
+	const char * rest = NULL;
+	char * end;
+	long number;
+	int k;
+
+	for (k = 0; k < 4 && rest == NULL; k++)
+	{
+		if (strncmp(text, kinds[k], strlen(kinds[k])) == SAME)
+		{
+			*kind = (uint32_t)k;
+			rest = text + strlen(kinds[k]);
+		}
+	}
+	if (rest == NULL)
+	{
+		printError("Error: Unknown key %s (use reads=, writes=, target= or imm=).\n", text);
+		return 0;
+	}
+
+	if (*kind <= KIND_WRITES && rest[0] == '$')
+	{
+		number = getRegNbr(rest);
+		end = (number < 0) ? (char *)rest : (char *)rest + strlen(rest);
+	}
+	else if (*kind == KIND_TARGET)
+	{
+		number = (long)strtoul(rest, &end, 0);
+	}
+	else
+	{
+		number = strtol(rest, &end, 0);
+	}
+
+	if (rest[0] == '\0' || *end != '\0'
+		|| (*kind <= KIND_WRITES && (number < 0 || number > 31))
+		|| (*kind == KIND_TARGET && (number < 0 || number > 0xFFFFFFFFL))
+		|| (*kind == KIND_IMM && (number < -32768 || number > 65535)))
+	{
+		printError("Error: Bad value in key %s.\n", text);
+		return 0;
+	}
+
+	*value = *kind == KIND_IMM ? (uint32_t)number & 0xFFFF : (uint32_t)number;
+	return 1;
+}
+
+/* Binary search of the index's keys. */
+static const XrefKey * findKey(const void * index, uint32_t kind, uint32_t value)
+{
+	const XrefHeader * header = index;
+	const XrefKey * keys = (const XrefKey *)(header + 1);
+	XrefKey wanted = { kind, value, 0, 0, 0 };
+
+	return bsearch(&wanted, keys, header->nKeys, sizeof(XrefKey), compareKeys);
+}